@@ -204,6 +204,8 @@ namespace codec {
 	  private:
 		std::vector<std::vector<GoP>> gops_;
 		std::vector<std::vector<common::Slice>> results_;
+		common::EncoderStat_t                   stat_;    /* Zstd decisions and coded size of all GoPs */
+		std::vector<std::vector<float>>         budgets_; /* Bytes of each GoP under rate control, same shape as gops_, empty if rate control is off */
 
 	  public:
 		void SetGoPs(std::vector<std::vector<GoP>> _gops);
@@ -212,13 +214,27 @@ namespace codec {
 
 		void SaveSlices();
 
+		/*
+		 * @description : Append throughput and bitrate of this preset to io.result_file/encoder_report.txt
+		 * @param  : {size_t _total} Bytes of all slices
+		 * @return : {}
+		 * */
+		void SaveReport(size_t _total);
+
+		/*
+		 * @description : Write target and achieved bitrate of each second of content, i.e., 30 frames, to io.result_file/rate_report.txt
+		 * @param  : {const std::vector<int>& _frame_size} Bytes of slices of each frame
+		 * @return : {}
+		 * */
+		void SaveRateReport(const std::vector<int>& _frame_size);
+
 		std::vector<std::vector<common::Slice>> GetResults();
 
 	  private:
-		std::vector<std::thread> threads_;
 		std::queue<int> task_queue_;
 		std::mutex task_queue_mutex_;
 		std::mutex log_mutex_;
+		std::mutex stat_mutex_;
 
 		void Task();
 
@@ -254,6 +270,7 @@ namespace codec {
 		std::vector<pcl::PointCloud<pcl::PointXYZRGB>::Ptr> results_;
 
 		float avg_geo, avg_y;
+		float avg_time; /* Decoding time per frame in ms, loading and metrics are excluded */
 		int psnr_cnt;
 
 	  public:
@@ -263,7 +280,6 @@ namespace codec {
 
 	  private:
 		std::vector<octree::InvertRAHTOctree> handler_;
-		std::vector<std::thread> threads_;
 		std::queue<int> task_queue_;
 		std::mutex task_queue_mutex_;
 
@@ -274,6 +290,13 @@ namespace codec {
 	};
 
 	extern void BuildFrames(common::PVVCParam_t::Ptr _param);
+
+	/*
+	 * @description : Train Zstd dictionaries of geometry and color from slices in io.result_file, save them as io.geometry_dict and io.color_dict
+	 * @param  : {common::PVVCParam_t::Ptr _param}
+	 * @return : {}
+	 * */
+	extern void TrainDictionaries(common::PVVCParam_t::Ptr _param);
 }  // namespace codec
 }  // namespace vvc
 #endif
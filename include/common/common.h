@@ -29,9 +29,9 @@
 namespace vvc {
 namespace common {
 	/*
-	 * From low to high : valid 1 | I 0 P 1 | none 0 skip 1 | none 0 zstd 1 | none 0 zstd 1
+	 * From low to high : valid 1 | I 0 P 1 | none 0 skip 1 | none 0 zstd 1 | none 0 zstd 1 | none 0 split 1 | RLGR 0 arithmetic 1 | none 0 extend 1
 	 * */
-	enum PVVC_SLICE_TYPE { PVVC_SLICE_TYPE_VALID, PVVC_SLICE_TYPE_PREDICT, PVVC_SLICE_TYPE_SKIP, PVVC_SLICE_TYPE_GEO_ZSTD, PVVC_SLICE_TYPE_COLOR_ZSTD };
+	enum PVVC_SLICE_TYPE { PVVC_SLICE_TYPE_VALID, PVVC_SLICE_TYPE_PREDICT, PVVC_SLICE_TYPE_SKIP, PVVC_SLICE_TYPE_GEO_ZSTD, PVVC_SLICE_TYPE_COLOR_ZSTD, PVVC_SLICE_TYPE_COLOR_SPLIT, PVVC_SLICE_TYPE_COLOR_ARITH, PVVC_SLICE_TYPE_EXTEND };
 
 	enum PVVC_SLICE_TYPE_CONFIG {
 		PVVC_SLICE_TYPE_CONFIG_INVALID,
@@ -43,9 +43,60 @@ namespace common {
 		PVVC_SLICE_TYPE_CONFIG_GEO_NOZSTD,
 		PVVC_SLICE_TYPE_CONFIG_GEO_ZSTD,
 		PVVC_SLICE_TYPE_CONFIG_COLOR_NOZSTD,
-		PVVC_SLICE_TYPE_CONFIG_COLOR_ZSTD
+		PVVC_SLICE_TYPE_CONFIG_COLOR_ZSTD,
+		PVVC_SLICE_TYPE_CONFIG_COLOR_NOSPLIT,
+		PVVC_SLICE_TYPE_CONFIG_COLOR_SPLIT,
+		PVVC_SLICE_TYPE_CONFIG_COLOR_RLGR,
+		PVVC_SLICE_TYPE_CONFIG_COLOR_ARITH,
+		PVVC_SLICE_TYPE_CONFIG_NOEXTEND,
+		PVVC_SLICE_TYPE_CONFIG_EXTEND
 	};
 
+	/*
+	 * Extension byte, follows the type byte only if PVVC_SLICE_TYPE_EXTEND is set.
+	 * From low to high : raw 0 arithmetic 1 occupancy | float 0 integer 1 RAHT | whole 0 per level 1 color | uniform 0 per level 1 quantization step
+	 * */
+	enum PVVC_SLICE_EXT { PVVC_SLICE_EXT_GEO_ARITH, PVVC_SLICE_EXT_INT_RAHT, PVVC_SLICE_EXT_LEVEL_COLOR, PVVC_SLICE_EXT_LEVEL_QUANT };
+
+	enum PVVC_SLICE_EXT_CONFIG {
+		PVVC_SLICE_EXT_CONFIG_GEO_RAW,
+		PVVC_SLICE_EXT_CONFIG_GEO_ARITH,
+		PVVC_SLICE_EXT_CONFIG_FLOAT_RAHT,
+		PVVC_SLICE_EXT_CONFIG_INT_RAHT,
+		PVVC_SLICE_EXT_CONFIG_WHOLE_COLOR,
+		PVVC_SLICE_EXT_CONFIG_LEVEL_COLOR,
+		PVVC_SLICE_EXT_CONFIG_UNIFORM_QUANT,
+		PVVC_SLICE_EXT_CONFIG_LEVEL_QUANT
+	};
+
+	/*
+	 * Color of a split slice is three independent RLGR substreams, Y U V, each starts with a new adaptive state.
+	 * Byte sizes of Y and U substreams are written before them, 32-bit big-endian, V takes the rest.
+	 * */
+	static int PVVC_SLICE_COLOR_SPLIT_TABLE = 8;
+
+	/*
+	 * Color of a level slice is one substream per octree level, from root to leaves, each is coded as a whole color stream, split or not.
+	 * Substream of level d holds coefficients refining level d - 1 to level d, i.e., [size - n_d, size - n_{d-1}) in coding order,
+	 * n_d is node number of level d and n_{-1} is 0, so levels 0 to d are enough to reconstruct level d.
+	 * Byte sizes of all substreams are written before them, 32-bit big-endian each.
+	 * */
+	static int PVVC_SLICE_COLOR_LEVEL_ENTRY = 4;
+
+	/*
+	 * Coefficients of a level quant slice are quantized with a step for each octree level, level d of an octree of height h uses
+	 * qp * 2^(-level_step * (h - 1 - d) / PVVC_SLICE_LEVEL_STEP_UNIT), i.e., leaves use qp and each level above is finer.
+	 * One byte of level_step follows qp in slice header. A step is never smaller than PVVC_SLICE_MIN_LEVEL_STEP, the resolution of fixed-point colors,
+	 * in both encoder and decoder, so a bad level_step cannot make huge symbols.
+	 * Integer RAHT slices use fixed-point steps computed in integer arithmetic only, 2^(-k / PVVC_SLICE_LEVEL_STEP_UNIT) is looked up in
+	 * PVVC_SLICE_LEVEL_STEP_TABLE, so the steps, and then the stream, never depend on libm.
+	 * */
+	static float PVVC_SLICE_LEVEL_STEP_UNIT = 16.0f;
+	static float PVVC_SLICE_MIN_LEVEL_STEP  = 1.0f / 256.0f;
+
+	/* round(2^16 * 2^(-k / 16)) for k in [0, 16), one entry per PVVC_SLICE_LEVEL_STEP_UNIT */
+	static int64_t PVVC_SLICE_LEVEL_STEP_TABLE[16] = {65536, 62757, 60097, 57549, 55109, 52773, 50535, 48393, 46341, 44376, 42495, 40693, 38968, 37316, 35734, 34219};
+
 	static uint8_t PVVC_SLICE_TYPE_MASK[8] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80};
 
 	static uint8_t PVVC_SLICE_TYPE_DEFAULT_INTRA = 0b00000001;
@@ -64,6 +115,21 @@ namespace common {
 		}
 	}
 
+	inline bool CheckSliceExt(uint8_t _type, uint8_t _ext, PVVC_SLICE_EXT _MASK) {
+		return CheckSliceType(_type, PVVC_SLICE_TYPE_EXTEND) && (_ext & PVVC_SLICE_TYPE_MASK[_MASK]) != 0;
+	}
+
+	/* Set a bit of extension byte, the extend bit of type is set iff extension byte is not zero */
+	inline void SetSliceExt(uint8_t& _type, uint8_t& _ext, PVVC_SLICE_EXT_CONFIG _MASK) {
+		if (_MASK & 0x01) {
+			_ext |= PVVC_SLICE_TYPE_MASK[_MASK >> 1];
+		}
+		else {
+			_ext &= (~PVVC_SLICE_TYPE_MASK[_MASK >> 1]);
+		}
+		SetSliceType(_type, _ext ? PVVC_SLICE_TYPE_CONFIG_EXTEND : PVVC_SLICE_TYPE_CONFIG_NOEXTEND);
+	}
+
 	/* Three channels color implementation, Y/Cb/Cr or Y/U/V */
 	struct ColorYUV {
 		float y, u, v; /* Channels */
@@ -277,37 +343,43 @@ namespace common {
 
 	/* Coded Patch, named Slice */
 	struct Slice {
-		int                                   timestamp; /* Time stamp */
-		int                                   index;     /* Patch index */
-		uint8_t                               type;      /* Slice type, intra / inter / TODO:skip / direct */
-		Eigen::Matrix4f                       mv;        /* Motion vector */
-		size_t                                size;      /* Total point number */
-		uint8_t                               qp;        /* Quantization parameter */
-		std::shared_ptr<std::vector<uint8_t>> geometry;  /* Compressed geometry, only valid if type is intra */
-		std::shared_ptr<std::vector<uint8_t>> color;     /* Compressed color, valid if type is intra or inter */
-
-		Slice() : timestamp{-1}, index{-1}, type{0x00}, mv{Eigen::Matrix4f::Identity()}, size{0}, qp{1}, geometry{}, color{} {}
-
-		Slice(const Slice& _x) : timestamp{_x.timestamp}, index{_x.index}, type{_x.type}, mv{_x.mv}, size{_x.size}, qp{_x.qp}, geometry{_x.geometry}, color{_x.color} {}
+		int                                   timestamp;  /* Time stamp */
+		int                                   index;      /* Patch index */
+		uint8_t                               type;       /* Slice type, intra / inter / skip / direct */
+		uint8_t                               ext;        /* Extension of slice type, valid if type is extend */
+		Eigen::Matrix4f                       mv;         /* Motion vector */
+		size_t                                size;       /* Total point number */
+		uint8_t                               qp;         /* Quantization parameter */
+		uint8_t                               level_step; /* Finer step per level above leaves, valid if ext is level quant */
+		std::shared_ptr<std::vector<uint8_t>> geometry;   /* Compressed geometry, only valid if type is intra */
+		std::shared_ptr<std::vector<uint8_t>> color;      /* Compressed color, valid if type is intra or inter but not skip */
+
+		Slice() : timestamp{-1}, index{-1}, type{0x00}, ext{0x00}, mv{Eigen::Matrix4f::Identity()}, size{0}, qp{1}, level_step{0}, geometry{}, color{} {}
+
+		Slice(const Slice& _x)
+		    : timestamp{_x.timestamp}, index{_x.index}, type{_x.type}, ext{_x.ext}, mv{_x.mv}, size{_x.size}, qp{_x.qp}, level_step{_x.level_step}, geometry{_x.geometry}, color{_x.color} {}
 
 		Slice& operator=(const Slice& _x) {
 			this->timestamp = _x.timestamp;
 			this->index = _x.index;
 			this->type = _x.type;
+			this->ext = _x.ext;
 			this->geometry = _x.geometry;
 			this->color = _x.color;
 			this->size = _x.size;
 			this->qp = _x.qp;
+			this->level_step = _x.level_step;
 			this->mv = _x.mv;
 			return *this;
 		}
 
 		void clear() {
 			this->timestamp = this->index = -1;
-			this->type = 0;
+			this->type = this->ext = 0;
 			this->mv = Eigen::Matrix4f::Identity();
 			this->size = 0;
 			this->qp = 1;
+			this->level_step = 0;
 			this->geometry.reset();
 			this->color.reset();
 		}
@@ -364,15 +436,17 @@ namespace common {
 		uint32_t                                           slice_cnt;
 		std::vector<int>                                   index;
 		std::vector<uint8_t>                               type;
+		std::vector<uint8_t>                               ext;
 		std::vector<uint32_t>                              size;
 		std::vector<uint32_t>                              geometry_size;
 		std::vector<uint32_t>                              color_size;
 		std::vector<uint8_t>                               qp;
+		std::vector<uint8_t>                               level_step;
 		std::vector<Eigen::Matrix4f>                       mv;
 		std::vector<std::shared_ptr<std::vector<uint8_t>>> geometry;
 		std::vector<std::shared_ptr<std::vector<uint8_t>>> color;
 
-		Frame() : timestamp{-1}, slice_cnt{}, index{}, type{}, size{}, geometry_size{}, color_size{}, qp{}, mv{}, geometry{}, color{} {}
+		Frame() : timestamp{-1}, slice_cnt{}, index{}, type{}, ext{}, size{}, geometry_size{}, color_size{}, qp{}, level_step{}, mv{}, geometry{}, color{} {}
 		~Frame() = default;
 
 		Frame(const std::vector<common::Slice>& _slices) {
@@ -391,6 +465,7 @@ namespace common {
 			for (auto& i : _slices) {
 				this->index.emplace_back(i.index);
 				this->type.emplace_back(i.type);
+				this->ext.emplace_back(i.ext);
 				this->size.emplace_back(i.size);
 				if (!i.geometry) {
 					this->geometry_size.emplace_back(0);
@@ -405,6 +480,7 @@ namespace common {
 					this->color_size.emplace_back(i.color->size());
 				}
 				this->qp.emplace_back(i.qp);
+				this->level_step.emplace_back(i.level_step);
 				this->mv.emplace_back(i.mv);
 				this->geometry.emplace_back(i.geometry);
 				this->color.emplace_back(i.color);
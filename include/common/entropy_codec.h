@@ -15,9 +15,13 @@
 #ifndef _PVVC_ENTROPY_CODEC_H_
 #define _PVVC_ENTROPY_CODEC_H_
 
+#include <algorithm>
+#include <map>
 #include <math.h>
 #include <memory>
+#include <mutex>
 #include <numeric>
+#include <string.h>
 #include <vector>
 #include <zstd.h>
 
@@ -86,15 +90,19 @@ namespace common {
 	 * RLGREncoder enc;
 	 * enc.Encode(Your_data);
 	 * result = enc.GetResult();
+	 * or, without any allocation after warming up,
+	 * enc.Encode(data_ptr, data_size);
+	 * use enc.GetBuffer() and enc.GetBufferSize();
 	 * */
 	class RLGREncoder {
 	  private:
-		FIX_INT                               buffer_; /* Bitstream buffer */
-		int                                   cnt_;    /* Valid bit count in buffer */
-		std::shared_ptr<std::vector<uint8_t>> result_; /* Encoding result */
+		FIX_INT              buffer_; /* Left-aligned bitstream buffer, MSB is the first bit */
+		int                  cnt_;    /* Valid bit count in buffer */
+		std::vector<uint8_t> stream_; /* Encoding result, grows and is reused by all Encode */
+		size_t               size_;   /* Valid byte count in stream_ */
 
 		/*
-		 * @description : Flush buffer_, output highest 8-bit data.
+		 * @description : Flush buffer_, output a whole 64-bit word big-endian.
 		 * */
 		void Flush();
 
@@ -104,7 +112,7 @@ namespace common {
 		void Write(uint8_t _x);
 
 		/*
-		 * @description : Write _bits data into buffer_.
+		 * @description : Write _bits data into buffer_, _x should be less than pow(2, _bits).
 		 * */
 		void Write(FIX_INT _x, int _bits);
 
@@ -116,10 +124,15 @@ namespace common {
 		void GRWrite(FIX_INT _x, int _bits);
 
 		/*
-		 * @description : Reset encoder
+		 * @description : Output remaining bits of buffer_, padding zero to byte
+		 * */
+		void Finish();
+
+		/*
+		 * @description : Reset encoder, stream_ is kept
 		 * */
 		inline void Reset() {
-			this->result_ = std::make_shared<std::vector<uint8_t>>();
+			this->size_   = 0;
 			this->cnt_    = 0;
 			this->buffer_ = 0;
 		}
@@ -140,11 +153,37 @@ namespace common {
 		void Encode(std::shared_ptr<std::vector<FIX_DATA_INT>> _data);
 
 		/*
-		 * @description : Get result, using std::move
+		 * @description : According to [1], encode _size data from _data into the internal buffer
+		 * @param  : {const FIX_DATA_INT* _data}
+		 * @param  : {int _size}
+		 * @return : {}
+		 * */
+		void Encode(const FIX_DATA_INT* _data, int _size);
+
+		/*
+		 * @description : Get result, a copy of internal buffer
 		 * @param  : {}
 		 * @return : {std::vector<uint8_t>}
 		 * */
 		std::shared_ptr<std::vector<uint8_t>> GetResult();
+
+		/*
+		 * @description : Get internal buffer, valid until next Encode
+		 * @param  : {}
+		 * @return : {const uint8_t*}
+		 * */
+		inline const uint8_t* GetBuffer() const {
+			return this->stream_.data();
+		}
+
+		/*
+		 * @description : Get byte count of internal buffer
+		 * @param  : {}
+		 * @return : {size_t}
+		 * */
+		inline size_t GetBufferSize() const {
+			return this->size_;
+		}
 	};
 
 	/*
@@ -161,6 +200,11 @@ namespace common {
 		std::shared_ptr<std::vector<FIX_DATA_INT>> result_;    /* Decoding result */
 		std::vector<uint8_t>::iterator             now_, end_; /* Iterator of decoded data */
 
+		FIX_INT        word_;                 /* Left-aligned bit window, MSB is the next bit */
+		int            word_cnt_;             /* Valid bits in word_ */
+		int            word_pad_;             /* Zero bits appended to word_ after the end of stream */
+		const uint8_t *word_now_, *word_end_; /* Byte cursor of word_ */
+
 		/*
 		 * @description : Get data to fill the buffer
 		 * */
@@ -187,6 +231,44 @@ namespace common {
 		 * */
 		FIX_INT GRRead(int _bits);
 
+		/*
+		 * @description : Refill word_ up to at least 57 valid bits, eight bytes at a time if possible, zero after the end of stream
+		 * */
+		void WordFill();
+
+		/*
+		 * @description : Drop highest _bits bits of word_, _bits must be less than 64
+		 * @param  : {int _bits}
+		 * */
+		inline void WordSkip(int _bits) {
+			this->word_ <<= _bits;
+			this->word_cnt_ -= _bits;
+		}
+
+		/*
+		 * @description : Count leading 1-bits of word_ without consuming them, at most _max
+		 * @param  : {int _max}
+		 * @return : {int}
+		 * */
+		inline int WordOnes(int _max) const {
+			int ones = ~this->word_ ? __builtin_clzll(~this->word_) : FIX_BIT_COUNT;
+			return ones < _max ? ones : _max;
+		}
+
+		/*
+		 * @description : Read _bits data from word_
+		 * @param  : {int _bits}
+		 * @return : {FIX_INT}
+		 * */
+		FIX_INT WordRead(int _bits);
+
+		/*
+		 * @description : Golomb-Rice decode _bits data from word_, quotient is counted by clz
+		 * @param  : {int _bits}
+		 * @return : {FIX_INT}
+		 * */
+		FIX_INT WordGRRead(int _bits);
+
 		/*
 		 * @description : Check decoded data stream reaches end
 		 * @param  : {}
@@ -221,6 +303,40 @@ namespace common {
 		 * */
 		void Decode(std::shared_ptr<std::vector<uint8_t>> _data, int _size);
 
+		/*
+		 * @description : Decode data into _result word-at-a-time, should generate _size decoding result.
+		 * Unary prefixes and runs of zero are consumed by counting leading ones, zeros are written in bulk.
+		 * Output is identical to Decode(_data, _size), but GetResult() is not touched.
+		 * @param  : {std::shared_ptr<std::vector<uint8_t>> _data}
+		 * @param  : {FIX_DATA_INT* _result} at least _size elements
+		 * @param  : {int _size}
+		 * @return : {}
+		 * */
+		void Decode(std::shared_ptr<std::vector<uint8_t>> _data, FIX_DATA_INT* _result, int _size);
+
+		/*
+		 * @description : Same as above, decode _length bytes from _data, e.g., a substream inside a slice payload
+		 * @param  : {const uint8_t* _data}
+		 * @param  : {size_t _length}
+		 * @param  : {FIX_DATA_INT* _result} at least _size elements
+		 * @param  : {int _size}
+		 * @return : {}
+		 * */
+		void Decode(const uint8_t* _data, size_t _length, FIX_DATA_INT* _result, int _size);
+
+		/*
+		 * @description : Decode _size symbols from a borrowed buffer, e.g., a mmapped file, into a caller-provided span without any copy.
+		 * Stream is not owned and may be followed by other data, _consumed is the bytes up to the last decoded bit.
+		 * @param  : {const uint8_t* _data}
+		 * @param  : {size_t _length}
+		 * @param  : {FIX_DATA_INT* _result}
+		 * @param  : {size_t _capacity} elements of _result, OUT_OF_RANGE if less than _size
+		 * @param  : {int _size}
+		 * @param  : {size_t& _consumed}
+		 * @return : {}
+		 * */
+		void Decode(const uint8_t* _data, size_t _length, FIX_DATA_INT* _result, size_t _capacity, int _size, size_t& _consumed);
+
 		/*
 		 * @description : Get decoding result, using std::move
 		 * @return : {std::vector<FIX_DATA_INT>}
@@ -228,10 +344,399 @@ namespace common {
 		std::shared_ptr<std::vector<FIX_DATA_INT>> GetResult();
 	};
 
+	/* Probability precision of binary arithmetic coder, 15 bits, so that highly skewed bits, e.g., zero coefficients, cost little */
+	static const int ARITH_PROB_BITS = 15;
+	/* Initial probability of 0-bit, i.e., 0.5 */
+	static const uint16_t ARITH_PROB_INIT = 1 << (ARITH_PROB_BITS - 1);
+	/* Adaptation speed, shift grows from ARITH_MOVE_MIN to ARITH_MOVE_MAX as bits are coded, a larger one adapts slower */
+	static const int ARITH_MOVE_MIN = 2;
+	static const int ARITH_MOVE_MAX = 5;
+	/* Renormalize when range is less than 2^24 */
+	static const uint32_t ARITH_RANGE_TOP = 1u << 24;
+
+	/* Adaptive probability of a binary context */
+	struct ArithContext_t {
+		uint16_t prob;  /* Probability of 0-bit, scaled by 2^ARITH_PROB_BITS */
+		uint16_t count; /* Coded bits, saturated, decides adaptation speed */
+
+		ArithContext_t() : prob{ARITH_PROB_INIT}, count{0} {}
+
+		/* Adapt fast at first and slow down, so that sparse contexts learn quickly and stable ones become precise */
+		inline void Update(int _bit) {
+			int shift = std::min(ARITH_MOVE_MIN + (this->count >> 2), ARITH_MOVE_MAX);
+			if (shift < ARITH_MOVE_MAX) {
+				this->count++;
+			}
+			if (!_bit) {
+				this->prob += ((1 << ARITH_PROB_BITS) - this->prob) >> shift;
+			}
+			else {
+				this->prob -= this->prob >> shift;
+			}
+		}
+	};
+
+	/*
+	 * Adaptive binary arithmetic encoder, range coder with carry propagation, probability of 0-bit is adapted after each bit.
+	 * How to use ?
+	 * ArithmeticEncoder enc;
+	 * enc.Reset();
+	 * Loop {
+	 *     enc.EncodeBit(ctx, bit);     // ctx is an ArithContext_t
+	 *     enc.EncodeBypass(x, bits);   // equiprobable bits
+	 * }
+	 * enc.Finish();
+	 * use enc.GetBuffer() and enc.GetBufferSize();
+	 * */
+	class ArithmeticEncoder {
+	  private:
+		uint64_t             low_;        /* Low end of interval, bit 32 is carry */
+		uint32_t             range_;      /* Interval width */
+		uint8_t              cache_;      /* Byte which may be changed by carry */
+		uint64_t             cache_size_; /* Cached byte and following 0xff bytes */
+		std::vector<uint8_t> stream_;     /* Output buffer, reused by all Encode */
+		size_t               size_;       /* Bytes written into stream_ */
+
+		/* Output the top byte of low_ */
+		void ShiftLow();
+
+	  public:
+		/* Default constructor and deconstructor */
+		ArithmeticEncoder();
+
+		~ArithmeticEncoder() = default;
+
+		/*
+		 * @description : Start a new stream, buffer is kept
+		 * @return : {}
+		 * */
+		void Reset();
+
+		/*
+		 * @description : Encode a bit with adaptive probability
+		 * @param  : {ArithContext_t& _ctx}
+		 * @param  : {int _bit}
+		 * @return : {}
+		 * */
+		void EncodeBit(ArithContext_t& _ctx, int _bit);
+
+		/*
+		 * @description : Encode _bits low bits of _x without modeling, MSB first
+		 * @param  : {FIX_INT _x}
+		 * @param  : {int _bits}
+		 * @return : {}
+		 * */
+		void EncodeBypass(FIX_INT _x, int _bits);
+
+		/*
+		 * @description : Flush the interval, must be called once after the last bit
+		 * @return : {}
+		 * */
+		void Finish();
+
+		/*
+		 * @description : Encoding result, valid until next Reset
+		 * @return : {const uint8_t*}
+		 * */
+		const uint8_t* GetBuffer() const;
+
+		/*
+		 * @description : Bytes of encoding result
+		 * @return : {size_t}
+		 * */
+		size_t GetBufferSize() const;
+	};
+
+	/*
+	 * Adaptive binary arithmetic decoder, probabilities must be initialized and updated in the same way as encoder.
+	 * Reading beyond the stream returns zero bytes.
+	 * */
+	class ArithmeticDecoder {
+	  private:
+		uint32_t       range_; /* Interval width */
+		uint32_t       code_;  /* Code value inside interval */
+		const uint8_t* now_;   /* Next byte */
+		const uint8_t* end_;   /* End of stream */
+
+		/* Next byte, 0 beyond the end */
+		uint8_t Next();
+
+	  public:
+		/* Default constructor and deconstructor */
+		ArithmeticDecoder();
+
+		~ArithmeticDecoder() = default;
+
+		/*
+		 * @description : Start decoding _length bytes from _data
+		 * @param  : {const uint8_t* _data}
+		 * @param  : {size_t _length}
+		 * @return : {}
+		 * */
+		void Reset(const uint8_t* _data, size_t _length);
+
+		/*
+		 * @description : Decode a bit with adaptive probability
+		 * @param  : {ArithContext_t& _ctx}
+		 * @return : {int}
+		 * */
+		int DecodeBit(ArithContext_t& _ctx);
+
+		/*
+		 * @description : Decode _bits equiprobable bits, MSB first
+		 * @param  : {int _bits}
+		 * @return : {FIX_INT}
+		 * */
+		FIX_INT DecodeBypass(int _bits);
+	};
+
+	/* Context number of RAHT coefficients in each channel, see octree::RAHTContext */
+	static const int COEFFICIENT_CONTEXT_NUM = 32;
+	/* Unary coded bins of magnitude, larger magnitude is escaped by Exp-Golomb code */
+	static const int COEFFICIENT_MAGNITUDE_BINS = 14;
+	/* Modeled bins of Exp-Golomb prefix, suffix bits are bypass coded */
+	static const int COEFFICIENT_ESCAPE_BINS = 24;
+
+	/* Adaptive probabilities of one coefficient context */
+	struct CoefficientModel_t {
+		ArithContext_t zero[3];                               /* |x| == 0, selected by magnitude of previous coefficient, 0/1/more */
+		ArithContext_t sign;                                  /* x < 0 */
+		ArithContext_t magnitude[COEFFICIENT_MAGNITUDE_BINS]; /* |x| - 1 > k */
+		ArithContext_t escape[COEFFICIENT_ESCAPE_BINS];       /* Exp-Golomb prefix > k */
+	};
+
+	/*
+	 * Context-adaptive arithmetic encoder of quantized RAHT coefficients, an alternative to RLGREncoder.
+	 * Each coefficient has a context in [0, COEFFICIENT_CONTEXT_NUM) given by caller, e.g., octree level and node weight,
+	 * each channel has its own models.
+	 * How to use ?
+	 * CoefficientEncoder enc;
+	 * enc.Encode(data_ptr, context_ptr, size, channels);
+	 * use enc.GetBuffer() and enc.GetBufferSize();
+	 * */
+	class CoefficientEncoder {
+	  private:
+		ArithmeticEncoder               enc_;    /* Binary arithmetic encoder */
+		std::vector<CoefficientModel_t> models_; /* Models of each channel and context */
+
+	  public:
+		/* Default constructor and deconstructor */
+		CoefficientEncoder();
+
+		~CoefficientEncoder() = default;
+
+		/*
+		 * @description : Encode _channels planes of _size coefficients, all planes share _context
+		 * @param  : {const FIX_DATA_INT* _data} _channels * _size elements
+		 * @param  : {const uint8_t* _context} _size elements
+		 * @param  : {int _size}
+		 * @param  : {int _channels}
+		 * @return : {}
+		 * */
+		void Encode(const FIX_DATA_INT* _data, const uint8_t* _context, int _size, int _channels);
+
+		/*
+		 * @description : Encoding result, valid until next Encode
+		 * @return : {const uint8_t*}
+		 * */
+		const uint8_t* GetBuffer() const;
+
+		/*
+		 * @description : Bytes of encoding result
+		 * @return : {size_t}
+		 * */
+		size_t GetBufferSize() const;
+	};
+
+	/*
+	 * Context-adaptive arithmetic decoder of quantized RAHT coefficients, contexts must be same as encoder.
+	 * */
+	class CoefficientDecoder {
+	  private:
+		ArithmeticDecoder               dec_;    /* Binary arithmetic decoder */
+		std::vector<CoefficientModel_t> models_; /* Models of each channel and context */
+
+	  public:
+		/* Default constructor and deconstructor */
+		CoefficientDecoder();
+
+		~CoefficientDecoder() = default;
+
+		/*
+		 * @description : Decode _channels planes of _size coefficients
+		 * @param  : {const uint8_t* _data}
+		 * @param  : {size_t _length}
+		 * @param  : {const uint8_t* _context} _size elements
+		 * @param  : {FIX_DATA_INT* _result} at least _channels * _size elements
+		 * @param  : {int _size}
+		 * @param  : {int _channels}
+		 * @return : {}
+		 * */
+		void Decode(const uint8_t* _data, size_t _length, const uint8_t* _context, FIX_DATA_INT* _result, int _size, int _channels);
+	};
+
+	/* Context number of occupancy bits, bit position 8 x adjacent neighbors 8 x coded subnode neighbors 8 x coded siblings 3 x parent occupancy 3 */
+	static const int OCCUPANCY_CONTEXT_NUM = 4608;
+	/* Subnode coordinates of levels below it fit in a 63-bit Morton code, deeper levels do not use neighbors */
+	static const int OCCUPANCY_NEIGHBOR_LEVEL = 21;
+
+	/*
+	 * Context-modelled arithmetic encoder of octree occupancy bytes, in breadth-first order as octree::RAHTOctree::GetOctree.
+	 * Bit k of a byte (0x80 >> k) is subnode k, k = xyz, which is coded with the context of
+	 * (1) k, (2) occupied neighbors of this node on the three faces touching subnode k,
+	 * (3) occupied neighbors of subnode k in -x/-y/-z, which are already coded,
+	 * (4) number of occupied subnodes already coded in this byte, (5) occupancy of parent node.
+	 * The last bit is inferred if the other seven are zero, since a branch node is not empty.
+	 * How to use ?
+	 * OccupancyEncoder enc;
+	 * enc.Encode(occupancy_ptr, occupancy_size, branch_levels);
+	 * use enc.GetBuffer() and enc.GetBufferSize();
+	 * */
+	class OccupancyEncoder {
+	  private:
+		ArithmeticEncoder           enc_;    /* Binary arithmetic encoder */
+		std::vector<ArithContext_t> models_; /* Models of each context */
+
+	  public:
+		/* Default constructor and deconstructor */
+		OccupancyEncoder();
+
+		~OccupancyEncoder() = default;
+
+		/*
+		 * @description : Encode occupancy bytes of _levels branch levels
+		 * @param  : {const uint8_t* _data}
+		 * @param  : {size_t _size} should be the number of branch nodes
+		 * @param  : {int _levels} tree height - 1
+		 * @return : {}
+		 * */
+		void Encode(const uint8_t* _data, size_t _size, int _levels);
+
+		/*
+		 * @description : Encoding result, valid until next Encode
+		 * @return : {const uint8_t*}
+		 * */
+		const uint8_t* GetBuffer() const;
+
+		/*
+		 * @description : Bytes of encoding result
+		 * @return : {size_t}
+		 * */
+		size_t GetBufferSize() const;
+	};
+
+	/*
+	 * Context-modelled arithmetic decoder of octree occupancy bytes, contexts are same as OccupancyEncoder.
+	 * */
+	class OccupancyDecoder {
+	  private:
+		ArithmeticDecoder           dec_;    /* Binary arithmetic decoder */
+		std::vector<ArithContext_t> models_; /* Models of each context */
+
+	  public:
+		/* Default constructor and deconstructor */
+		OccupancyDecoder();
+
+		~OccupancyDecoder() = default;
+
+		/*
+		 * @description : Decode occupancy bytes of _levels branch levels, append them to _result
+		 * @param  : {const uint8_t* _data}
+		 * @param  : {size_t _length}
+		 * @param  : {int _levels} tree height - 1
+		 * @param  : {size_t _leaves} leaf number, no level can have more nodes
+		 * @param  : {std::vector<uint8_t>& _result}
+		 * @return : {}
+		 * */
+		void Decode(const uint8_t* _data, size_t _length, int _levels, size_t _leaves, std::vector<uint8_t>& _result);
+	};
+
+	/* Zstandard dictionary used by a payload */
+	enum ZSTD_DICT_TYPE { ZSTD_DICT_NONE, ZSTD_DICT_GEOMETRY, ZSTD_DICT_COLOR };
+
+	/*
+	 * Trained Zstandard dictionaries, one for octree occupancy bytes and one for RLGR color bytes, shared by all threads.
+	 * Encoder selects a dictionary by ZSTD_DICT_TYPE, the dictionary ID is written in Zstandard frame header,
+	 * decoder selects dictionary by this ID.
+	 * How to use?
+	 * ZstdDictionary::Init().Load(param);
+	 * */
+	class ZstdDictionary {
+	  private:
+		struct Dict_t {
+			std::vector<uint8_t>       data;   /* Raw dictionary */
+			ZSTD_DDict*                ddict;  /* Digested dictionary for decompression */
+			std::map<int, ZSTD_CDict*> cdicts; /* Digested dictionaries for compression, key is the compression level, kept until destruction */
+		};
+
+		std::mutex                     mutex_;   /* Guard of dicts_ */
+		std::map<unsigned int, Dict_t> dicts_;   /* Loaded dictionaries, key is the dictionary ID */
+		unsigned int                   id_[3];   /* Dictionary ID of each ZSTD_DICT_TYPE, 0 is none */
+		std::string                    path_[3]; /* Dictionary file of each ZSTD_DICT_TYPE */
+
+		/* Singleton */
+		ZstdDictionary();
+
+		~ZstdDictionary();
+
+	  public:
+		ZstdDictionary(const ZstdDictionary&) = delete;
+
+		ZstdDictionary& operator=(const ZstdDictionary&) = delete;
+
+		/*
+		 * @description : Get instance
+		 * @param  : {}
+		 * @return : {ZstdDictionary&}
+		 * */
+		static ZstdDictionary& Init();
+
+		/*
+		 * @description : Load dictionaries in io.geometry_dict and io.color_dict, empty path is ignored, loaded file will not be reloaded
+		 * @param  : {PVVCParam_t::Ptr _param}
+		 * @return : {}
+		 * */
+		void Load(PVVCParam_t::Ptr _param);
+
+		/*
+		 * @description : Add a dictionary for _type, replace the previous one of _type
+		 * @param  : {ZSTD_DICT_TYPE _type}
+		 * @param  : {const std::vector<uint8_t>& _dict}
+		 * @return : {}
+		 * */
+		void Add(ZSTD_DICT_TYPE _type, const std::vector<uint8_t>& _dict);
+
+		/*
+		 * @description : Check whether a dictionary of _type is loaded
+		 * @param  : {ZSTD_DICT_TYPE _type}
+		 * @return : {bool}
+		 * */
+		bool Has(ZSTD_DICT_TYPE _type);
+
+		/*
+		 * @description : Get digested dictionary of _type at compression level _level, it stays valid until the process exits
+		 * @param  : {ZSTD_DICT_TYPE _type}
+		 * @param  : {int _level}
+		 * @return : {const ZSTD_CDict*} nullptr if no dictionary
+		 * */
+		const ZSTD_CDict* GetCDict(ZSTD_DICT_TYPE _type, int _level);
+
+		/*
+		 * @description : Get digested dictionary with ID _id
+		 * @param  : {unsigned int _id}
+		 * @return : {const ZSTD_DDict*} nullptr if no dictionary
+		 * */
+		const ZSTD_DDict* GetDDict(unsigned int _id);
+	};
+
+	/*
+	 * Zstandard Encoder, compression context is reused by all encoders in the same thread.
+	 * */
 	class ZstdEncoder {
 	  private:
 		PVVCParam_t::Ptr                      params_; /* patchVVC parameters */
 		std::shared_ptr<std::vector<uint8_t>> result_; /* Encoding result */
+		ZSTD_DICT_TYPE                        dict_;   /* Dictionary used by Encode */
 
 	  public:
 		/* Default constructor and deconstructor */
@@ -247,12 +752,27 @@ namespace common {
 		std::shared_ptr<std::vector<uint8_t>> GetResult() const;
 
 		/*
-		 * @description : Set patchVVC parameters
+		 * @description : Set patchVVC parameters, dictionaries in parameters are loaded
 		 * @param  : {PVVCParam_t::Ptr _param}
 		 * @return : {}
 		 * */
 		void SetParams(PVVCParam_t::Ptr _param);
 
+		/*
+		 * @description : Set dictionary used by following Encode, ZSTD_DICT_NONE by default
+		 * @param  : {ZSTD_DICT_TYPE _type}
+		 * @return : {}
+		 * */
+		void SetDictionary(ZSTD_DICT_TYPE _type);
+
+		/*
+		 * @description : Predict whether Zstd can make _data smaller, using order-0 entropy of bytes.
+		 * Always true if preset.zstd_estimate is disabled or a dictionary is used.
+		 * @param  : {std::shared_ptr<std::vector<uint8_t>> _data}
+		 * @return : {bool} false if Zstd is not expected to help
+		 * */
+		bool Estimate(std::shared_ptr<std::vector<uint8_t>> _data) const;
+
 		/*
 		 * @description : Encode data
 		 * @param  : {std::shared_ptr<std::vector<uint8_t>> _data}
@@ -261,6 +781,10 @@ namespace common {
 		void Encode(std::shared_ptr<std::vector<uint8_t>> _data);
 	};
 
+	/*
+	 * Zstandard Decoder, decompression context is reused by all decoders in the same thread.
+	 * Dictionary is selected by the dictionary ID in frame header, it should be loaded in ZstdDictionary.
+	 * */
 	class ZstdDecoder {
 	  private:
 		std::shared_ptr<std::vector<uint8_t>> result_; /* Decoding result */
@@ -284,6 +808,26 @@ namespace common {
 		 * @return : {}
 		 * */
 		void Decode(std::shared_ptr<std::vector<uint8_t>> _data);
+
+		/*
+		 * @description : Decompressed size of the Zstd frame at the head of _data, use it to size the output span
+		 * @param  : {const uint8_t* _data}
+		 * @param  : {size_t _length}
+		 * @return : {size_t} 0 if unknown or not a Zstd frame
+		 * */
+		static size_t ContentSize(const uint8_t* _data, size_t _length);
+
+		/*
+		 * @description : Decode the Zstd frame at the head of a borrowed buffer, e.g., a mmapped file, into a caller-provided span without any copy.
+		 * Bytes behind the frame are not touched, _consumed is the compressed frame size. GetResult() is not touched.
+		 * @param  : {const uint8_t* _data}
+		 * @param  : {size_t _length}
+		 * @param  : {uint8_t* _result}
+		 * @param  : {size_t _capacity} bytes of _result, OUT_OF_RANGE if less than ContentSize
+		 * @param  : {size_t& _consumed}
+		 * @return : {size_t} decompressed bytes
+		 * */
+		size_t Decode(const uint8_t* _data, size_t _length, uint8_t* _result, size_t _capacity, size_t& _consumed);
 	};
 
 	/*
@@ -134,6 +134,7 @@ namespace common {
 		EMPTY_REFERENCE,       /* error occured when try to decode a predictive slice without intra slice */
 		INVALID_DIR,           /* error occured when try to access a invalid directory or directory path actually is a file */
 		UNMATCHED_PATCH_SIZE,  /* error occured when adjcent frames have difference patch num */
+		MISSING_DICTIONARY,    /* error occured when decode a Zstandard frame whose dictionary is not loaded */
 	};
 
 	static std::string ErrorMessage[100] = {
@@ -162,6 +163,7 @@ namespace common {
 	    "no reference for predictive slice",
 	    "invalid directory, path maybe not exist or actually a file",
         "unmatched patch number",
+	    "Zstandard dictionary of this frame is not loaded",
 	};
 
 }  // namespace common
@@ -25,6 +25,9 @@ namespace common {
 	enum SEGMENT_TYPE { DENSE_SEGMENT };
 	enum ICP_TYPE { SIMPLE_ICP, LM_ICP, NORMAL_ICP, GENERAL_ICP };
 	enum SPLIT_TYPE { PLANAR_BISECTION, PARTIAL_CLUSTERING, DIRECT_CLUSTERING };
+	enum ENCODE_PRESET { CUSTOM_PRESET, FAST_PRESET, BALANCED_PRESET, ARCHIVAL_PRESET };
+	enum COLOR_CODER_TYPE { RLGR_COLOR_CODER, ARITHMETIC_COLOR_CODER, AUTO_COLOR_CODER };
+	enum GEOMETRY_CODER_TYPE { RAW_GEOMETRY_CODER, ARITHMETIC_GEOMETRY_CODER, AUTO_GEOMETRY_CODER };
 	struct PVVCParam_t {
 		uint8_t log_level;       /* quiet brief normal complete */
 		uint8_t check_point;     /* from low to high : none first_segment all_segment fitting encoding saving */
@@ -41,8 +44,16 @@ namespace common {
 			std::string source_file;  /* Souce point clouds */
 			std::string segment_file; /* Middle results */
 			std::string deform_file;
-			std::string result_file; /* Coding results */
+			std::string result_file;   /* Coding results */
+			std::string geometry_dict; /* Zstd dictionary of octree occupancy, optional */
+			std::string color_dict;    /* Zstd dictionary of RLGR color, optional */
 		} io;
+		/* Encoding speed preset */
+		struct {
+			ENCODE_PRESET type;          /* Preset, zstd_level in cfg is used by CUSTOM_PRESET */
+			int           zstd_strategy; /* Zstd strategy, 0 means the default strategy of zstd_level */
+			bool          zstd_estimate; /* Estimate entropy of payload and skip Zstd if no gain is expected */
+		} preset;
 		/* Parameters of segmentation */
 		struct {
 			int          num;       /* Point number in each patch */
@@ -62,11 +73,25 @@ namespace common {
 		} icp;
 		/* Parameters of patch encoding */
 		struct {
-			uint8_t qp_i, qp_p; /* Quantization parameter of i_patch and p_patch */
+			uint8_t             qp_i, qp_p;     /* Quantization parameter of i_patch and p_patch */
+			bool                split_color;    /* Code Y/U/V as independent substreams */
+			COLOR_CODER_TYPE    color_coder;    /* Entropy coder of quantized RAHT coefficients */
+			GEOMETRY_CODER_TYPE geometry_coder; /* Entropy coder of octree occupancy bytes */
+			bool                int_raht;       /* Fixed-point lifting RAHT, bit-exact in all decoders */
+			bool                level_color;    /* Code color as one substream per octree level, so level of detail decoding skips deeper levels */
+			float               skip_ths;       /* P slice is coded as skip if ratio of its nonzero quantized coefficients is not larger than it, 0 only skips all-zero ones, negative never skips */
+			uint8_t             level_step;     /* Quantization step of each octree level above leaves is finer by level_step / 16 octave, 0 is uniform, at most 32 */
+			float               dead_zone;      /* Zero bin of quantization is widened by dead_zone step on each side, in [0, 0.5], 0 is rounding */
 		} slice;
+		/* Parameters of rate control */
+		struct {
+			float target_kbps; /* Target bitrate at 30 fps, QPs of each GoP are scaled from qp_i and qp_p to fit its share, 0 means fixed QPs */
+			bool  first_pass;  /* Correct rate model of each slice by coding it at chosen QPs, slices whose QP does not move are kept */
+		} rate;
 		/* Parameters of octree */
 		struct {
-			float resolution; /* Min resolution of octree, edge length of cube in the last level */
+			float resolution;   /* Min resolution of octree, edge length of cube in the last level */
+			int   parallel_ths; /* Min leaves of octree to run RAHT layer by layer on thread_num threads, 0 means never */
 		} octree;
 		/* Parameters of patch fitting */
 		struct {
@@ -78,6 +103,11 @@ namespace common {
 			int        interpolation_num;  /* k in KNN search of color interpolation */
 		} patch;
 
+		struct {
+			bool geometry_only; /* Decode positions only, color payload is neither entropy decoded nor transformed */
+			int  lod;           /* Level of detail, decode octree down to this depth, one point per node colored by its low-pass coefficient, 0 means full depth */
+		} decode;
+
 		using Ptr = std::shared_ptr<const PVVCParam_t>;
 
 		void Log() const;
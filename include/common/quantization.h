@@ -0,0 +1,148 @@
+/* Copyright Notice.
+ *
+ * Please read the LICENSE file in the project root directory for details
+ * of the open source licenses referenced by this source code.
+ *
+ * Copyright: @ChenRP07. All Right Reserved.
+ *
+ * Author        : ChenRP07
+ * Description   : Vectorized quantization and dequantization of RAHT coefficients.
+ * Create Time   : 2026/10/17 10:12
+ * Last Modified : 2026/10/17 10:12
+ *
+ */
+
+#ifndef _PVVC_QUANTIZATION_H_
+#define _PVVC_QUANTIZATION_H_
+
+#include "common/common.h"
+#include "common/entropy_codec.h"
+
+namespace vvc {
+namespace common {
+
+	/*
+	 * Kernels work on structure-of-arrays planes, i.e., all Y, then all U, then all V.
+	 * AVX2 or SSE4.1 version is selected at runtime by CPU features, scalar version otherwise.
+	 * All versions give bit-exact results of the scalar expressions below:
+	 * quantize   : q = static_cast<FIX_DATA_INT>(std::round(x / static_cast<float>(qp))), i.e., round half away from zero
+	 * dequantize : x = static_cast<float>(q * qp)
+	 * */
+
+	/*
+	 * @description : Quantize _size coefficients of one plane
+	 * @param  : {const float* _src}
+	 * @param  : {FIX_DATA_INT* _dst}
+	 * @param  : {size_t _size}
+	 * @param  : {int _qp} quantization step, positive
+	 * @return : {}
+	 * */
+	extern void Quantize(const float* _src, FIX_DATA_INT* _dst, size_t _size, int _qp);
+
+	/*
+	 * @description : Dequantize _size symbols of one plane
+	 * @param  : {const FIX_DATA_INT* _src}
+	 * @param  : {float* _dst}
+	 * @param  : {size_t _size}
+	 * @param  : {int _qp} quantization step, positive
+	 * @return : {}
+	 * */
+	extern void Dequantize(const FIX_DATA_INT* _src, float* _dst, size_t _size, int _qp);
+
+	/*
+	 * @description : Quantize _size ColorYUV coefficients into three planes, _dst[0, _size) is Y, then U and V
+	 * @param  : {const ColorYUV* _src}
+	 * @param  : {FIX_DATA_INT* _dst} at least 3 * _size elements
+	 * @param  : {size_t _size}
+	 * @param  : {int _qp}
+	 * @return : {}
+	 * */
+	extern void QuantizeYUV(const ColorYUV* _src, FIX_DATA_INT* _dst, size_t _size, int _qp);
+
+	/*
+	 * @description : Dequantize three planes of symbols into three planes of coefficients, layout is same as QuantizeYUV
+	 * @param  : {const FIX_DATA_INT* _src} 3 * _size elements
+	 * @param  : {float* _dst} at least 3 * _size elements
+	 * @param  : {size_t _size}
+	 * @param  : {int _qp}
+	 * @return : {}
+	 * */
+	extern void DequantizeYUV(const FIX_DATA_INT* _src, float* _dst, size_t _size, int _qp);
+
+	/*
+	 * @description : Quantize _size fixed-point coefficients of integer RAHT, q = round(x / _step) half away from zero, in integer arithmetic only
+	 * @param  : {const int32_t* _src}
+	 * @param  : {FIX_DATA_INT* _dst}
+	 * @param  : {size_t _size}
+	 * @param  : {int64_t _step} quantization step in fixed-point, positive
+	 * @return : {}
+	 * */
+	extern void QuantizeFixed(const int32_t* _src, FIX_DATA_INT* _dst, size_t _size, int64_t _step);
+
+	/*
+	 * @description : Dequantize _size symbols into fixed-point coefficients of integer RAHT, x = q * _step
+	 * @param  : {const FIX_DATA_INT* _src}
+	 * @param  : {int32_t* _dst}
+	 * @param  : {size_t _size}
+	 * @param  : {int64_t _step} quantization step in fixed-point, positive
+	 * @return : {}
+	 * */
+	extern void DequantizeFixed(const FIX_DATA_INT* _src, int32_t* _dst, size_t _size, int64_t _step);
+
+	/*
+	 * @description : Quantize _size coefficients of one plane with a dead zone, q = sign(x) * floor(|x| / _step + 0.5 - _dead_zone),
+	 * i.e., round if _dead_zone is 0, zero bin is widened by _dead_zone * _step on each side and other bins are moved outwards
+	 * @param  : {const float* _src}
+	 * @param  : {FIX_DATA_INT* _dst}
+	 * @param  : {size_t _size}
+	 * @param  : {float _step} positive
+	 * @param  : {float _dead_zone} in [0, 0.5]
+	 * @return : {}
+	 * */
+	extern void QuantizeDeadZone(const float* _src, FIX_DATA_INT* _dst, size_t _size, float _step, float _dead_zone);
+
+	/*
+	 * @description : Dequantize _size symbols of one plane by a non-integer step, x = q * _step
+	 * @param  : {const FIX_DATA_INT* _src}
+	 * @param  : {float* _dst}
+	 * @param  : {size_t _size}
+	 * @param  : {float _step}
+	 * @return : {}
+	 * */
+	extern void DequantizeStep(const FIX_DATA_INT* _src, float* _dst, size_t _size, float _step);
+
+	/*
+	 * @description : Quantize _size fixed-point coefficients of integer RAHT with a dead zone, same as QuantizeDeadZone in integer arithmetic only
+	 * @param  : {const int32_t* _src}
+	 * @param  : {FIX_DATA_INT* _dst}
+	 * @param  : {size_t _size}
+	 * @param  : {int64_t _step} quantization step in fixed-point, positive
+	 * @param  : {int64_t _dead_zone} widening of zero bin on each side in fixed-point, in [0, _step / 2]
+	 * @return : {}
+	 * */
+	extern void QuantizeFixedDeadZone(const int32_t* _src, FIX_DATA_INT* _dst, size_t _size, int64_t _step, int64_t _dead_zone);
+
+	/*
+	 * @description : Quantization step of octree level _depth in a level quant slice, check PVVC_SLICE_LEVEL_STEP_UNIT for details
+	 * @param  : {int _qp}
+	 * @param  : {uint8_t _level_step}
+	 * @param  : {int _height} octree height
+	 * @param  : {int _depth} level, 0 is root
+	 * @return : {float}
+	 * */
+	extern float LevelStep(int _qp, uint8_t _level_step, int _height, int _depth);
+
+	/*
+	 * @description : Fixed-point quantization step of octree level _depth in a level quant slice of integer RAHT,
+	 * round(_step * 2^(-_level_step * (_height - 1 - _depth) / 16)) by PVVC_SLICE_LEVEL_STEP_TABLE, at least 1.
+	 * It is a part of the stream format, encoder and all decoders must use it rather than LevelStep.
+	 * @param  : {int64_t _step} fixed-point step of leaves, i.e., qp << INT_RAHT_FRAC_BITS
+	 * @param  : {uint8_t _level_step}
+	 * @param  : {int _height} octree height
+	 * @param  : {int _depth} level, 0 is root
+	 * @return : {int64_t}
+	 * */
+	extern int64_t LevelStepFixed(int64_t _step, uint8_t _level_step, int _height, int _depth);
+}  // namespace common
+}  // namespace vvc
+#endif
@@ -48,7 +48,20 @@ namespace common {
 		std::vector<float> avg_iters;
 	};
 
-    struct EncoderStat_t {};
+	/* Zstd decisions and payload size of slice encoding */
+	struct EncoderStat_t {
+		int    zstd_tried;   /* Payloads compressed by Zstd */
+		int    zstd_skipped; /* Payloads not compressed since estimation predicts no gain */
+		int    zstd_used;    /* Payloads which are smaller after Zstd */
+		int    skip_slices;  /* P slices coded as skip, header only */
+		size_t geometry;     /* Bytes of geometry */
+		size_t color;        /* Bytes of color */
+
+		EncoderStat_t() : zstd_tried{}, zstd_skipped{}, zstd_used{}, skip_slices{}, geometry{}, color{} {}
+
+		EncoderStat_t& operator+=(const EncoderStat_t& _x);
+	};
+
 	extern float Deviation(const std::vector<int>& _src);
 	extern float Deviation(const std::vector<float>& _src);
 }  // namespace common
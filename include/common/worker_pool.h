@@ -0,0 +1,108 @@
+/* Copyright Notice.
+ *
+ * Please read the LICENSE file in the project root directory for details
+ * of the open source licenses referenced by this source code.
+ *
+ * Copyright: @ChenRP07, All Right Reserved.
+ *
+ * Author        : ChenRP07
+ * Description   : Process-wide worker threads for data parallel loops inside one task.
+ * Create Time   : 2026/10/17 16:05
+ * Last Modified : 2026/10/17 16:05
+ *
+ */
+
+#ifndef _PVVC_WORKER_POOL_H_
+#define _PVVC_WORKER_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace vvc {
+namespace common {
+
+	/*
+	 * Class WorkerPool, a fixed number of threads taking jobs from a queue.
+	 * ParallelFor runs a loop in the calling thread and only waits for indexes already started by workers,
+	 * so it never deadlocks when called from a worker or when all workers are busy, it just runs serially.
+	 * Before each index, the caller queues a helper job for each free worker while indexes are left, so loops can be nested,
+	 * an inner loop gets the workers which run out of indexes of an outer loop, and busy workers never leave stale jobs in the queue.
+	 * How to use?
+	 * auto& pool = WorkerPool::Global(thread_num);
+	 * pool.ParallelFor(count, [&](size_t i) { ... });
+	 * */
+	class WorkerPool {
+	  private:
+		std::vector<std::thread>          workers_; /* Worker threads */
+		std::queue<std::function<void()>> jobs_;    /* Jobs waiting for a worker */
+		std::mutex                        mutex_;   /* Lock of jobs_, stop_ and changes of free_ */
+		std::condition_variable           cond_;    /* Notify workers of a new job or stop */
+		bool                              stop_;    /* Workers exit if set */
+		std::atomic<size_t>               free_;    /* Workers neither running a job nor wanted by a queued job, read without lock as a hint */
+
+		/* State of a ParallelFor call */
+		struct Loop_t;
+
+		/* Loop of each worker */
+		void Work();
+
+		/*
+		 * @description : Run indexes of _loop until none is left, the caller of ParallelFor also offers helper jobs to free workers
+		 * @param  : {const std::shared_ptr<Loop_t>& _loop}
+		 * @param  : {bool _offer}
+		 * @return : {}
+		 * */
+		void Run(const std::shared_ptr<Loop_t>& _loop, bool _offer);
+
+		/*
+		 * @description : Queue helper jobs of _loop for free workers, at most one for each index left and workers number in total
+		 * @param  : {const std::shared_ptr<Loop_t>& _loop}
+		 * @return : {}
+		 * */
+		void Offer(const std::shared_ptr<Loop_t>& _loop);
+
+	  public:
+		/*
+		 * @description : Launch _threads workers
+		 * @param  : {int _threads}
+		 * */
+		explicit WorkerPool(int _threads);
+
+		/* Finish queued jobs and join workers */
+		~WorkerPool();
+
+		WorkerPool(const WorkerPool&)            = delete;
+		WorkerPool& operator=(const WorkerPool&) = delete;
+
+		/*
+		 * @description : Workers number
+		 * @param  : {}
+		 * @return : {int}
+		 * */
+		int size() const;
+
+		/*
+		 * @description : Call _func(i) for each i in [0, _count), return after all calls are done, then rethrow the first exception thrown by _func if any
+		 * @param  : {size_t _count}
+		 * @param  : {const std::function<void(size_t)>& _func} must be safe to run concurrently for different i
+		 * @return : {}
+		 * */
+		void ParallelFor(size_t _count, const std::function<void(size_t)>& _func);
+
+		/*
+		 * @description : Pool shared by the whole process, created by the first call with _threads - 1 workers, the caller is the last one
+		 * @param  : {int _threads}
+		 * @return : {WorkerPool&}
+		 * */
+		static WorkerPool& Global(int _threads);
+	};
+}  // namespace common
+}  // namespace vvc
+#endif
@@ -61,9 +61,24 @@ namespace client {
 		__device__ __managed__ static uint8_t PVVC_SLICE_TYPE_MASK[8] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80};
 
 		/*
-		 * From low to high : valid 1 | I 0 P 1 | none 0 skip 1 | none 0 zstd 1 | none 0 zstd 1
+		 * From low to high : valid 1 | I 0 P 1 | none 0 skip 1 | none 0 zstd 1 | none 0 zstd 1 | none 0 split 1 | RLGR 0 arithmetic 1 | none 0 extend 1
 		 * */
-		enum PVVC_SLICE_TYPE { PVVC_SLICE_TYPE_VALID, PVVC_SLICE_TYPE_PREDICT, PVVC_SLICE_TYPE_SKIP, PVVC_SLICE_TYPE_GEO_ZSTD, PVVC_SLICE_TYPE_COLOR_ZSTD };
+		enum PVVC_SLICE_TYPE { PVVC_SLICE_TYPE_VALID, PVVC_SLICE_TYPE_PREDICT, PVVC_SLICE_TYPE_SKIP, PVVC_SLICE_TYPE_GEO_ZSTD, PVVC_SLICE_TYPE_COLOR_ZSTD, PVVC_SLICE_TYPE_COLOR_SPLIT, PVVC_SLICE_TYPE_COLOR_ARITH, PVVC_SLICE_TYPE_EXTEND };
+
+		/*
+		 * Extension byte, follows the type byte only if PVVC_SLICE_TYPE_EXTEND is set.
+		 * From low to high : raw 0 arithmetic 1 occupancy | float 0 integer 1 RAHT | whole 0 per level 1 color | uniform 0 per level 1 quantization step
+		 * Only integer RAHT is supported in client.
+		 * */
+		enum PVVC_SLICE_EXT { PVVC_SLICE_EXT_GEO_ARITH, PVVC_SLICE_EXT_INT_RAHT, PVVC_SLICE_EXT_LEVEL_COLOR, PVVC_SLICE_EXT_LEVEL_QUANT };
+
+		/* Byte size of Y/U substreams size table in front of split color, 32-bit big-endian each */
+		static const int PVVC_SLICE_COLOR_SPLIT_TABLE = 8;
+
+		/* Fractional bits of fixed-point colors and coefficients in integer RAHT */
+		static const int INT_RAHT_FRAC_BITS = 8;
+		/* Fractional bits of lifting coefficients in integer RAHT */
+		static const int INT_RAHT_LIFT_BITS = 16;
 
 		/*
 		 * @desciption : Check type of slice.
@@ -75,6 +90,27 @@ namespace client {
 			return _type & PVVC_SLICE_TYPE_MASK[_MASK];
 		}
 
+		/*
+		 * @desciption : Check extension of slice, always false if slice is not extended.
+		 * @param  : {uint8_t _type} slice_t.type
+		 * @param  : {uint8_t _ext} slice_t.ext
+		 * @param  : {PVVC_SLICE_EXT _MASK}
+		 * @return : {bool}
+		 * */
+		__host__ __device__ inline bool CheckSliceExt(uint8_t _type, uint8_t _ext, PVVC_SLICE_EXT _MASK) {
+			return CheckSliceType(_type, PVVC_SLICE_TYPE_EXTEND) && (_ext & PVVC_SLICE_TYPE_MASK[_MASK]);
+		}
+
+		/*
+		 * @desciption : Check extension of slice can be decoded in client, i.e., no extension bit other than integer RAHT.
+		 * @param  : {uint8_t _type} slice_t.type
+		 * @param  : {uint8_t _ext} slice_t.ext
+		 * @return : {bool}
+		 * */
+		__host__ __device__ inline bool CheckSliceExtSupported(uint8_t _type, uint8_t _ext) {
+			return !CheckSliceType(_type, PVVC_SLICE_TYPE_EXTEND) || (_ext & ~PVVC_SLICE_TYPE_MASK[PVVC_SLICE_EXT_INT_RAHT]) == 0;
+		}
+
 		/* Point with xyz */
 		struct PointXYZ {
 			float x, y, z;
@@ -175,6 +211,7 @@ namespace client {
 			int timestamp;          /* Time stamp */
 			int index;              /* Index in a frame */
 			uint8_t type;           /* Slice type */
+			uint8_t ext;            /* Slice extension, valid if type is extended */
 			MotionVector mv;        /* Motion vector */
 			uint32_t size;          /* Point number */
 			uint8_t qp;             /* QP */
@@ -184,10 +221,10 @@ namespace client {
 			uint32_t color_size;    /* Size of color info*/
 
 			/* Constructor */
-			__host__ __device__ Slice_t() : timestamp{}, index{}, type{}, mv{}, size{}, qp{}, geometry{}, geometry_size{}, color{}, color_size{} {}
+			__host__ __device__ Slice_t() : timestamp{}, index{}, type{}, ext{}, mv{}, size{}, qp{}, geometry{}, geometry_size{}, color{}, color_size{} {}
 
-			__device__ Slice_t(int _timestamp, int _index, uint8_t _type, float* _mv, uint32_t _size, uint8_t _qp, uint8_t* _geometry, uint32_t _geometry_size, uint8_t* _color, uint32_t _color_size)
-			    : timestamp{_timestamp}, index{_index}, type{_type}, size{_size}, qp{_qp}, geometry{_geometry}, geometry_size{_geometry_size}, color{_color}, color_size{_color_size} {
+			__device__ Slice_t(int _timestamp, int _index, uint8_t _type, uint8_t _ext, float* _mv, uint32_t _size, uint8_t _qp, uint8_t* _geometry, uint32_t _geometry_size, uint8_t* _color, uint32_t _color_size)
+			    : timestamp{_timestamp}, index{_index}, type{_type}, ext{_ext}, size{_size}, qp{_qp}, geometry{_geometry}, geometry_size{_geometry_size}, color{_color}, color_size{_color_size} {
 				for (int i = 0; i < 16; i++) {
 					this->mv.data[i] = _mv[i];
 				}
@@ -197,6 +234,7 @@ namespace client {
 				this->timestamp = _x.timestamp;
 				this->index = _x.index;
 				this->type = _x.type;
+				this->ext = _x.ext;
 				this->mv = _x.mv;
 				this->size = _x.size;
 				this->qp = _x.qp;
@@ -211,6 +249,7 @@ namespace client {
 				this->timestamp = _x.timestamp;
 				this->index = _x.index;
 				this->type = _x.type;
+				this->ext = _x.ext;
 				this->mv = _x.mv;
 				this->size = _x.size;
 				this->qp = _x.qp;
@@ -233,6 +272,8 @@ namespace client {
 			int* index;
 			/* Slice types */
 			uint8_t* type;
+			/* Slice extensions, 0 if not extended */
+			uint8_t* ext;
 			/* Slice mvs */
 			float** mv;
 			/* Point number of each Slice */
@@ -249,10 +290,11 @@ namespace client {
 			uint8_t** color;
 
 			/* Constructor and deconstructor */
-			Frame_t() : timestamp{}, slice_cnt{}, index{}, type{}, mv{}, size{}, qp{}, geometry_size{}, geometry{}, color_size{}, color{} {}
+			Frame_t() : timestamp{}, slice_cnt{}, index{}, type{}, ext{}, mv{}, size{}, qp{}, geometry_size{}, geometry{}, color_size{}, color{} {}
 			~Frame_t() {
 				delete[] (this->index);
 				delete[] (this->type);
+				delete[] (this->ext);
 				for (int i = 0; i < this->slice_cnt; ++i) {
 					delete[] (this->mv[i]);
 					if (this->geometry_size[i] != 0) {
@@ -276,6 +318,7 @@ namespace client {
 				this->timestamp = -1;
 				delete[] (this->index);
 				delete[] (this->type);
+				delete[] (this->ext);
 				for (int i = 0; i < this->slice_cnt; ++i) {
 					delete[] (this->mv[i]);
 					delete[] (this->geometry[i]);
@@ -336,6 +379,8 @@ namespace client {
 		int* index_gpu;
 		/* Slice type */
 		uint8_t* type_gpu;
+		/* Slice extension */
+		uint8_t* ext_gpu;
 		/* Slice point number */
 		uint32_t* size_gpu;
 		/* Slice qp */
@@ -359,7 +404,7 @@ namespace client {
 		int point_number;
 		/* Constructor */
 		CudaFrame_t()
-		    : index_gpu{}, inner_offset_gpu{}, type_gpu{}, size_gpu{}, qp_gpu{}, geometry_size_gpu{}, color_size_gpu{}, mv_gpu{}, geometry_gpu{}, color_gpu{}, point_number{}, slice_number{} {}
+		    : index_gpu{}, inner_offset_gpu{}, type_gpu{}, ext_gpu{}, size_gpu{}, qp_gpu{}, geometry_size_gpu{}, color_size_gpu{}, mv_gpu{}, geometry_gpu{}, color_gpu{}, point_number{}, slice_number{} {}
 	};
 
 	/* Sliec groups buffer */
@@ -30,6 +30,18 @@ namespace client {
 		 * */
 		extern __device__ void InvertHaarTransform(int _w0, int _w1, const common::ColorYUV& _g0, const common::ColorYUV& _g1, common::ColorYUV& _res0, common::ColorYUV& _res1);
 
+		/*
+		 * @description : Invert haar transform of integer RAHT, three lifting steps per channel, same as RAHTPlan::IntInvertTransform of encoder
+		 * @param  : {int _w0} weight of g0, must be > 0
+		 * @param  : {int _w1} weight of g1, must be > 0
+		 * @param  : {const int32_t* _g} fixed-point signal, three channels
+		 * @param  : {const int32_t* _h} fixed-point coefficient, three channels
+		 * @param  : {int32_t* _res0} fixed-point g0, three channels
+		 * @param  : {int32_t* _res1} fixed-point g1, three channels
+		 * @return : {}
+		 * */
+		extern __device__ void IntInvertHaarTransform(int _w0, int _w1, const int32_t* _g, const int32_t* _h, int32_t* _res0, int32_t* _res1);
+
 		/* Used to check if some bit of uint8_t is 0 or 1 */
 		__device__ static uint8_t NodeValue[8] = {0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01};
 
@@ -65,8 +77,11 @@ namespace client {
 			/* g_DC/h_xyz/h_xy/h_xy/h_x/h_x/h_x/h_x/g0/g1/g2/g3/g4/g5/g6/g7 */
 			common::ColorYUV raht[16];
 
+			/* Same as raht, Y/U/V fixed-point signals of integer RAHT */
+			int32_t int_raht[16][3];
+
 			/* Default constructor */
-			__device__ OctreeNode_t() : value{}, index{}, weight{}, raht{} {}
+			__device__ OctreeNode_t() : value{}, index{}, weight{}, raht{}, int_raht{} {}
 
 			/* Copy constructor and assign constructor */
 			__device__ OctreeNode_t(const OctreeNode_t& _x) : value{_x.value} {
@@ -80,6 +95,12 @@ namespace client {
 				for (int i = 0; i < 16; ++i) {
 					this->raht[i] = _x.raht[i];
 				}
+
+				for (int i = 0; i < 16; ++i) {
+					for (int c = 0; c < 3; ++c) {
+						this->int_raht[i][c] = _x.int_raht[i][c];
+					}
+				}
 			}
 
 			__device__ OctreeNode_t& operator=(const OctreeNode_t& _x) {
@@ -95,6 +116,12 @@ namespace client {
 				for (int i = 0; i < 16; ++i) {
 					this->raht[i] = _x.raht[i];
 				}
+
+				for (int i = 0; i < 16; ++i) {
+					for (int c = 0; c < 3; ++c) {
+						this->int_raht[i][c] = _x.int_raht[i][c];
+					}
+				}
 				return *this;
 			}
 
@@ -102,6 +129,9 @@ namespace client {
 			 * NOTE: Signals of raht[idx] is valid only if value & NodeValue[idx - 8] is not zero, i.e., this child node has weight > 0
 			 * */
 			__device__ void InvertHierarchicalTransform();
+
+			/* Same as InvertHierarchicalTransform, but on int_raht by integer lifting, a merge with an empty side just passes the signal down */
+			__device__ void IntInvertHierarchicalTransform();
 		};
 
 		/* Layer of octree Node*/
@@ -137,6 +167,7 @@ namespace client {
 			int               source_cloud_index_; /* Index of source_colors_*/
 			uint8_t*          node_values_;        /* Octree node sequence */
 			common::ColorYUV* coefficients_;       /* RAHT result coefficients */
+			int32_t*          int_coefficients_;   /* Fixed-point coefficients of integer RAHT slice, Y/U/V of each coefficient */
 			common::ColorYUV* reference_colors_;   /* Reference ColorYUV */
 			common::ColorYUV* source_colors_;      /* Result ColorYUV, after invert compensation */
 			common::Slice_t   slice_;              /* Slice to be decoded */
@@ -144,7 +175,7 @@ namespace client {
 		  public:
 			/* Default constructor and deconstructor */
 			__host__ __device__ InvertRAHTOctree()
-			    : tree_center_{}, tree_range_{}, tree_height_{}, tree_{}, source_cloud_{}, source_cloud_index_{}, node_values_{}, coefficients_{}, reference_colors_{}, source_colors_{}, slice_{} {}
+			    : tree_center_{}, tree_range_{}, tree_height_{}, tree_{}, source_cloud_{}, source_cloud_index_{}, node_values_{}, coefficients_{}, int_coefficients_{}, reference_colors_{}, source_colors_{}, slice_{} {}
 
 			// __device__ ~InvertRAHTOctree();
 
@@ -166,6 +197,14 @@ namespace client {
 			/* Do invert RAHT */
 			__device__ void InvertRAHT();
 
+			/*
+			 * @description : Dequantize a channel of RLGR result into coefficients_ or int_coefficients_
+			 * @param  : {int _channel} 0 Y, 1 U, 2 V
+			 * @param  : {const int64_t* _symbols} slice_.size quantized symbols
+			 * @return : {}
+			 * */
+			__device__ void Dequantize(int _channel, const int64_t* _symbols);
+
 			/* Create common octree */
 			__device__ void MakeTree();
 		};
@@ -46,6 +46,7 @@ namespace client {
                                 int* inner_offset, 
                                 int* index, 
                                 uint8_t* type, 
+                                uint8_t* ext, 
                                 float** mv, 
                                 uint32_t* size, 
                                 uint8_t* qp, 
@@ -17,6 +17,7 @@
 
 #include "common/common.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <regex>
 #include <filesystem>
@@ -31,6 +32,13 @@ namespace io {
 	 * */
 	[[nodiscard]] extern int SaveSlice(const common::Slice& _slice, const std::string& _name);
 
+	/*
+	 * @description : Bytes of slice header written by SaveSlice, i.e., all but geometry and color payloads, their size fields included.
+	 * @param  : {const common::Slice& _slice} only type and ext are used
+	 * @return : {size_t}
+	 * */
+	extern size_t SliceHeaderSize(const common::Slice& _slice);
+
 	/*
 	 * @description : Save patchVVC slice.
 	 * @param  : {const common::Slice& _slice}
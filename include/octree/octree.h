@@ -19,6 +19,8 @@
 #include "common/entropy_codec.h"
 #include "common/exception.h"
 #include "common/parameter.h"
+#include "common/quantization.h"
+#include "common/worker_pool.h"
 
 #include <pcl/point_cloud.h>
 #include <pcl/point_types.h>
@@ -78,68 +80,75 @@ namespace octree {
 	/* Used to specify two children indexes in haar transform */
 	static int NodeWeight[8][2] = {{0, 0}, {2, 3}, {4, 6}, {5, 7}, {8, 12}, {9, 13}, {10, 14}, {11, 15}};
 
-	/* Node of octree */
-	struct OctreeNode_t {
-		/*
-		    For a node, eight subnodes are
-		      6————4
-		     /|   /|
-		    2—+——0 |
-		    | 7——+-5
-		    |/   |/
-		    3————1
-		    x/y/z > center ? 0 : 1 -> xyz from 000 to 111
-		*/
-		uint8_t value;
-
-		/* Children indexes in next layer or in real point cloud */
-		std::vector<int> index;
-
-		/* Points number that this node contains
-		 * null/0-7/0246/1357/04/15/26/37/0/1/2/3/4/5/6/7 */
-		int weight[16];
-
-		/* g_DC/h_xyz/h_xy/h_xy/h_x/h_x/h_x/h_x/g0/g1/g2/g3/g4/g5/g6/g7 */
-		common::ColorYUV raht[16];
-
-		/* Default constructor */
-		OctreeNode_t() : value{}, index{}, weight{}, raht{} {}
-
-		/* Copy constructor and assign constructor */
-		OctreeNode_t(const OctreeNode_t& _x) : value{_x.value}, index{_x.index} {
-			for (int i = 0; i < 16; ++i) {
-				this->weight[i] = _x.weight[i];
-			}
-
-			for (int i = 0; i < 16; ++i) {
-				this->raht[i] = _x.raht[i];
-			}
+	/*
+	    For a node, eight subnodes are
+	      6————4
+	     /|   /|
+	    2—+——0 |
+	    | 7——+-5
+	    |/   |/
+	    3————1
+	    x/y/z > center ? 0 : 1 -> xyz from 000 to 111
+	*/
+
+	/* One layer of octree, nodes are stored as arrays in the order of occupancy bytes */
+	struct OctreeLayer_t {
+		/* Occupancy byte of each node, 0xff for leaf */
+		std::vector<uint8_t> value;
+
+		/* Index of the first child in next layer, children of a node are contiguous in subnode order, empty for leaf layer */
+		std::vector<int> child;
+
+		/* Points number that each node contains */
+		std::vector<int> weight;
+
+		/* Nodes number of this layer */
+		size_t size() const {
+			return this->value.size();
 		}
 
-		OctreeNode_t& operator=(const OctreeNode_t& _x) {
-			this->value = _x.value;
-			this->index = _x.index;
-
-			for (int i = 0; i < 16; ++i) {
-				this->weight[i] = _x.weight[i];
-			}
+		/* Reset to _size nodes, leaf nodes have value 0xff and weight 1, child is not used by leaf layer */
+		void assign(size_t _size, bool _leaf) {
+			this->value.assign(_size, _leaf ? 0xff : 0x00);
+			this->child.assign(_leaf ? 0 : _size, -1);
+			this->weight.assign(_size, _leaf ? 1 : 0);
+		}
 
-			for (int i = 0; i < 16; ++i) {
-				this->raht[i] = _x.raht[i];
-			}
-			return *this;
+		void clear() {
+			this->value.clear();
+			this->child.clear();
+			this->weight.clear();
 		}
+	};
 
-		/* Do RAHT in this node, need signals in raht[8] to raht[15], generate signal in raht[0] and coefficients in raht[1] to raht[7]
-		 * NOTE: Coefficient of raht[idx] is valid only if both NodeWeight[idx][0] and NodeWeight[idx][1] are not zero.
-		 * */
-		void HierarchicalTransform();
+	/*
+	 * @description : Expand weights of the _index-th node in branch layer _height into 16 slots
+	 * null/0-7/0246/1357/04/15/26/37/0/1/2/3/4/5/6/7
+	 * @param  : {const std::vector<OctreeLayer_t>& _tree}
+	 * @param  : {int _height}
+	 * @param  : {int _index}
+	 * @param  : {int (&_weight)[16]}
+	 * @return : {}
+	 * */
+	extern void ExpandWeight(const std::vector<OctreeLayer_t>& _tree, int _height, int _index, int (&_weight)[16]);
 
-		/* Do InvertRAHT in this node, need signal in raht[0] and coefficients in raht[1] to raht[7], genreate signals in raht[8] to raht[15]
-		 * NOTE: Signals of raht[idx] is valid only if value & NodeValue[idx - 8] is not zero, i.e., this child node has weight > 0
-		 * */
-		void InvertHierarchicalTransform();
-	};
+	/*
+	 * @description : Do RAHT in a node, need signals in _raht[8] to _raht[15], generate signal in _raht[0] and coefficients in _raht[1] to _raht[7]
+	 * NOTE: Coefficient of _raht[idx] is valid only if both NodeWeight[idx][0] and NodeWeight[idx][1] are not zero.
+	 * @param  : {const int (&_weight)[16]} weights from ExpandWeight
+	 * @param  : {common::ColorYUV (&_raht)[16]} g_DC/h_xyz/h_xy/h_xy/h_x/h_x/h_x/h_x/g0/g1/g2/g3/g4/g5/g6/g7
+	 * @return : {}
+	 * */
+	extern void HierarchicalTransform(const int (&_weight)[16], common::ColorYUV (&_raht)[16]);
+
+	/*
+	 * @description : Do InvertRAHT in a node, need signal in _raht[0] and coefficients in _raht[1] to _raht[7], genreate signals in _raht[8] to _raht[15]
+	 * NOTE: Signals of _raht[idx] is valid only if the (idx - 8)-th child node has weight > 0
+	 * @param  : {const int (&_weight)[16]} weights from ExpandWeight
+	 * @param  : {common::ColorYUV (&_raht)[16]}
+	 * @return : {}
+	 * */
+	extern void InvertHierarchicalTransform(const int (&_weight)[16], common::ColorYUV (&_raht)[16]);
 
 	/*
 	 * @description : Change float3 data _center, _range into 24 uint8_t data, save it with _height into _p
@@ -161,6 +170,165 @@ namespace octree {
 	 * */
 	extern void LoadTreeCore(pcl::PointXYZ& _center, pcl::PointXYZ& _range, int& _height, uint8_t (&_p)[25]);
 
+	/* Context of RAHT coefficient is level_bucket * RAHT_CONTEXT_WEIGHT + weight_bucket */
+	static int RAHT_CONTEXT_LEVEL  = 4; /* Levels counted from the last branch layer, upper levels share the last bucket */
+	static int RAHT_CONTEXT_WEIGHT = 8; /* floor(log2(weight)), larger weights share the last bucket */
+
+	static int MORTON_MAX_LEVEL = 21; /* Branch layers whose Morton keys fit in 64 bits, deeper trees are built recursively */
+
+	static int RAHT_BATCH_FRAMES = 4; /* Color sets transformed together by RAHTOctree::BatchRAHT, bounds its scratch size */
+
+	static size_t RAHT_PARALLEL_GRAIN = 1 << 14; /* Min butterflies of a parallel RAHT job, jobs are cut at node boundaries */
+
+	/* Integer RAHT, int32 fixed-point signals reach about 2 * 255 * √leaves * 2^INT_RAHT_FRAC_BITS in lifting */
+	static int INT_RAHT_FRAC_BITS  = 8;       /* Fractional bits of fixed-point colors and coefficients */
+	static int INT_RAHT_LIFT_BITS  = 16;      /* Fractional bits of lifting coefficients */
+	static int INT_RAHT_MAX_LEAVES = 1 << 24; /* Max leaves number of integer RAHT */
+
+	/*
+	 * @description : Compute context of each RAHT coefficient in coding order, i.e., g_DC last, from tree level and node weight.
+	 * Weights of all nodes must be computed.
+	 * @param  : {const std::vector<OctreeLayer_t>& _tree}
+	 * @param  : {std::vector<uint8_t>& _context}
+	 * @return : {}
+	 * */
+	extern void RAHTContext(const std::vector<OctreeLayer_t>& _tree, std::vector<uint8_t>& _context);
+
+	/*
+	 * @description : Worker pool for RAHT of an octree, nullptr if it should run serially, i.e., less than octree.parallel_ths leaves or one thread
+	 * @param  : {const common::PVVCParam_t::Ptr& _params}
+	 * @param  : {size_t _leaves}
+	 * @return : {common::WorkerPool*}
+	 * */
+	extern common::WorkerPool* RAHTPool(const common::PVVCParam_t::Ptr& _params, size_t _leaves);
+
+	/*
+	 * Class RAHTPlan, RAHT of a fixed octree flattened into a list of butterflies.
+	 * Node weights and haar coefficients only depend on geometry, so they are computed once in Build,
+	 * then Transform and InvertTransform are a linear sweep for each color set.
+	 * Signals are numbered as leaves [0, leaves), g of a butterfly overwrites its g0, so the scratch holds only leaves signals.
+	 * Results are same as HierarchicalTransform and InvertHierarchicalTransform of each node.
+	 * IntTransform and IntInvertTransform are the integer variant, each butterfly is a rotation by three lifting steps,
+	 * x += [p * y], y -= [s * x], x += [p * y], where p = tan(θ / 2), s = sin θ, cos θ = a, sin θ = b.
+	 * p and s are fixed-point computed from node weights by integer square root, rounding is (v + half) >> INT_RAHT_LIFT_BITS,
+	 * so integer results only depend on octree and input, and invert transform restores input exactly if no quantization.
+	 * How to use?
+	 * RAHTPlan plan;
+	 * plan.Build(tree);
+	 * Loop {
+	 *     plan.Transform(leaf_colors, coefficients);
+	 * }
+	 * */
+	class RAHTPlan {
+	  public:
+		/* g = a * g0 + b * g1, h = a * g1 - b * g0 */
+		struct Butterfly_t {
+			int   g0; /* Signal of the child with smaller index */
+			int   g1; /* Signal of the other child */
+			int   h;  /* Position of h in coding order */
+			float a;  /* √w0 / √(w0 + w1) */
+			float b;  /* √w1 / √(w0 + w1) */
+		};
+
+		/* Lifting steps of a butterfly in integer RAHT */
+		struct Lifting_t {
+			int32_t p; /* tan(θ / 2) = b / (1 + a), fixed-point */
+			int32_t s; /* sin θ = b, fixed-point */
+		};
+
+	  private:
+		std::vector<Butterfly_t> butterflies_; /* Butterflies from leaves to root */
+		size_t                   leaves_;      /* Leaves number, also coefficients number */
+		int                      root_;        /* Signal of g_DC */
+		std::vector<float>       signals_;     /* Scratch, Y/U/V of each signal */
+		std::vector<Lifting_t>   liftings_;    /* Lifting steps of each butterfly */
+		std::vector<int32_t>     int_signals_; /* Scratch of integer invert RAHT */
+		std::vector<size_t>      spans_;       /* Butterflies of j-th job are [spans_[j], spans_[j + 1]) */
+		std::vector<size_t>      levels_;      /* Jobs of l-th layer from leaves are [levels_[l], levels_[l + 1]), independent of each other */
+		common::WorkerPool*      pool_;        /* Jobs of a layer run in parallel on it, serial sweep if nullptr */
+
+		/*
+		 * @description : Run _job(begin, end) over all butterflies, serially or layer by layer in parallel, both give identical results
+		 * @param  : {Func _job} sweep of butterflies [begin, end), in reversed order if _invert
+		 * @param  : {bool _invert} layers from root to leaves
+		 * @return : {}
+		 * */
+		template <typename Func> void Sweep(Func _job, bool _invert) const;
+
+	  public:
+		/* Default constructor and deconstructor */
+		RAHTPlan();
+
+		~RAHTPlan() = default;
+
+		/*
+		 * @description : Flatten RAHT of _tree, weights of all nodes must be computed
+		 * @param  : {const std::vector<OctreeLayer_t>& _tree}
+		 * @return : {}
+		 * */
+		void Build(const std::vector<OctreeLayer_t>& _tree);
+
+		/*
+		 * @description : Leaves number, i.e., coefficients number of each channel
+		 * @param  : {}
+		 * @return : {size_t}
+		 * */
+		size_t size() const;
+
+		/*
+		 * @description : Run transforms on _pool layer by layer, nullptr for serial sweep, the pool must outlive this plan
+		 * @param  : {common::WorkerPool* _pool}
+		 * @return : {}
+		 * */
+		void SetPool(common::WorkerPool* _pool);
+
+		/*
+		 * @description : Do RAHT
+		 * @param  : {const common::ColorYUV* _leaves} signal of each leaf, in leaf layer order
+		 * @param  : {common::ColorYUV* _coefficients} size() coefficients in coding order, i.e., g_DC last
+		 * @return : {}
+		 * */
+		void Transform(const common::ColorYUV* _leaves, common::ColorYUV* _coefficients);
+
+		/*
+		 * @description : Do RAHT of _frames color sets together, each butterfly is applied to all of them in one loop.
+		 * Result of each color set is bit-identical to Transform. Scratch is given by caller, so calls with different scratches can run concurrently.
+		 * @param  : {const common::ColorYUV* _leaves} _frames x leaves matrix, _leaves[f * size() + i] is i-th leaf of f-th color set
+		 * @param  : {common::ColorYUV* const* _coefficients} _frames arrays, each of size() coefficients in coding order
+		 * @param  : {int _frames}
+		 * @param  : {std::vector<float>& _signals} scratch, resized here
+		 * @return : {}
+		 * */
+		void Transform(const common::ColorYUV* _leaves, common::ColorYUV* const* _coefficients, int _frames, std::vector<float>& _signals) const;
+
+		/*
+		 * @description : Do invert RAHT, optionally add a reference color to each leaf while writing it out
+		 * @param  : {const float* _coefficients} Y/U/V planes of size() coefficients in coding order
+		 * @param  : {common::ColorYUV* _leaves} signal of each leaf, in leaf layer order
+		 * @param  : {const common::ColorYUV* _reference} size() colors of predictive slice, nullptr for intra slice
+		 * @return : {}
+		 * */
+		void InvertTransform(const float* _coefficients, common::ColorYUV* _leaves, const common::ColorYUV* _reference);
+
+		/*
+		 * @description : Do integer RAHT, size() must not be larger than INT_RAHT_MAX_LEAVES. Calls with different scratches can run concurrently.
+		 * @param  : {const int32_t* _leaves} fixed-point Y/U/V of each leaf, in leaf layer order
+		 * @param  : {int32_t* _coefficients} fixed-point Y/U/V planes of size() coefficients in coding order
+		 * @param  : {std::vector<int32_t>& _signals} scratch, resized here
+		 * @return : {}
+		 * */
+		void IntTransform(const int32_t* _leaves, int32_t* _coefficients, std::vector<int32_t>& _signals) const;
+
+		/*
+		 * @description : Do integer invert RAHT, leaves are converted to float exactly, then optionally add a reference color
+		 * @param  : {const int32_t* _coefficients} fixed-point Y/U/V planes of size() coefficients in coding order
+		 * @param  : {common::ColorYUV* _leaves} signal of each leaf, in leaf layer order
+		 * @param  : {const common::ColorYUV* _reference} size() colors of predictive slice, nullptr for intra slice
+		 * @return : {}
+		 * */
+		void IntInvertTransform(const int32_t* _coefficients, common::ColorYUV* _leaves, const common::ColorYUV* _reference);
+	};
+
 	/* Base class of octree, a pure virtual class, need to rewrite MakeTree() */
 	class OctreeBase {
 	  protected:
@@ -222,13 +390,20 @@ namespace octree {
 	 *     tree.RAHT();
 	 *     color_result = tree.GetRAHTResult();
 	 * }
+	 * or for all color sets at once,
+	 * color_results = tree.BatchRAHT(colors_ptrs);
 	 * */
 	class RAHTOctree : public OctreeBase {
 	  private:
-		std::vector<std::vector<OctreeNode_t>>         tree_;          /* Tree nodes */
+		std::vector<OctreeLayer_t>                     tree_;          /* Tree layers */
+		std::vector<int>                               leaf_points_;   /* Point indexes of all leaves, leaf i has [leaf_offset_[i], leaf_offset_[i + 1]) */
+		std::vector<int>                               leaf_offset_;   /* Offset of each leaf in leaf_points_, one more element at the end */
+		std::vector<common::ColorYUV>                  leaf_colors_;   /* Averaged color of each leaf */
+		RAHTPlan                                       plan_;          /* Flattened RAHT of tree_ */
 		pcl::PointCloud<pcl::PointXYZRGB>::Ptr         source_cloud_;  /* Geometry of common patch */
 		std::shared_ptr<std::vector<common::ColorYUV>> source_colors_; /* YUV colors to be transformed */
 		std::shared_ptr<std::vector<common::ColorYUV>> RAHT_result_;   /* RAHT result */
+		std::vector<uint8_t>                           contexts_;      /* Context of each RAHT coefficient */
 
 		/*
 		 * @description : Add a node in _height layer.
@@ -240,6 +415,21 @@ namespace octree {
 		 * */
 		void AddNode(std::vector<int>& _points, const int _height, const pcl::PointXYZ _center, const pcl::PointXYZ _range);
 
+		/*
+		 * @description : Build all layers from sorted Morton keys of points, without recursion.
+		 * Result is identical to AddNode from the root, tree_height_ - 1 must not be larger than MORTON_MAX_LEVEL.
+		 * @return : {}
+		 * */
+		void MortonBuild();
+
+		/*
+		 * @description : Voxel downsampling, average colors of points in each leaf
+		 * @param  : {const std::vector<common::ColorYUV>& _colors} color of each point of source_cloud_
+		 * @param  : {common::ColorYUV* _leaves} color of each leaf, in leaf layer order
+		 * @return : {}
+		 * */
+		void LeafColors(const std::vector<common::ColorYUV>& _colors, common::ColorYUV* _leaves) const;
+
 	  public:
 		/* Default constructor and deconstructor */
 		RAHTOctree();
@@ -267,6 +457,13 @@ namespace octree {
 		 * */
 		std::shared_ptr<std::vector<uint8_t>> GetOctree() const;
 
+		/*
+		 * @description : Output octree as GetOctree, but occupancy bytes behind tree core are coded by common::OccupancyEncoder
+		 * @param  : {}
+		 * @return : {std::shared_ptr<std::vector<uint8_t>>}
+		 * */
+		std::shared_ptr<std::vector<uint8_t>> GetArithOctree() const;
+
 		/*
 		 * @description : Move color result to return value
 		 * @param  : {}
@@ -274,6 +471,20 @@ namespace octree {
 		 * */
 		std::shared_ptr<std::vector<common::ColorYUV>> GetRAHTResult();
 
+		/*
+		 * @description : Context of each RAHT coefficient, same order as GetRAHTResult, valid after MakeTree
+		 * @param  : {}
+		 * @return : {const std::vector<uint8_t>&}
+		 * */
+		const std::vector<uint8_t>& GetRAHTContext() const;
+
+		/*
+		 * @description : Node number of each octree level from root to leaves, level d is reconstructed by the last n_d coefficients, valid after MakeTree
+		 * @param  : {}
+		 * @return : {std::vector<int>}
+		 * */
+		std::vector<int> GetLevelSizes() const;
+
 		/*
 		 * @description : Do RAHT
 		 * @param  : {}
@@ -281,6 +492,21 @@ namespace octree {
 		 * */
 		void RAHT();
 
+		/*
+		 * @description : Do RAHT of color sets sharing this octree, RAHT_BATCH_FRAMES of them are transformed together, batches run in parallel on thread_num threads.
+		 * Result of each color set is same as SetSourceColors, RAHT and GetRAHTResult.
+		 * @param  : {const std::vector<std::shared_ptr<std::vector<common::ColorYUV>>>& _colors}
+		 * @return : {std::vector<std::shared_ptr<std::vector<common::ColorYUV>>>} coefficients of each color set
+		 * */
+		std::vector<std::shared_ptr<std::vector<common::ColorYUV>>> BatchRAHT(const std::vector<std::shared_ptr<std::vector<common::ColorYUV>>>& _colors);
+
+		/*
+		 * @description : Do integer RAHT of color sets sharing this octree, averaged leaf colors are rounded to fixed-point first, color sets run in parallel on thread_num threads
+		 * @param  : {const std::vector<std::shared_ptr<std::vector<common::ColorYUV>>>& _colors}
+		 * @return : {std::vector<std::shared_ptr<std::vector<int32_t>>>} fixed-point Y/U/V planes of coefficients of each color set, in coding order
+		 * */
+		std::vector<std::shared_ptr<std::vector<int32_t>>> IntRAHT(const std::vector<std::shared_ptr<std::vector<common::ColorYUV>>>& _colors);
+
 		/*
 		 * @description : Make octree
 		 * @param  : {}
@@ -303,23 +529,51 @@ namespace octree {
 	 * */
 	class InvertRAHTOctree : public OctreeBase {
 	  private:
-		std::vector<std::vector<OctreeNode_t>>         tree_;             /* Octree */
+		std::vector<OctreeLayer_t>                     tree_;             /* Octree layers */
+		RAHTPlan                                       plan_;             /* Flattened invert RAHT of tree_ down to lod_depth_, built with octree */
+		int                                            lod_depth_;        /* Depth of decoded level, tree_height_ - 1 if full, set by intra slice */
+		std::vector<float>                             lod_scales_;       /* 1 / √weight of nodes at lod_depth_, empty if full */
 		pcl::PointCloud<pcl::PointXYZ>::Ptr            source_cloud_;     /* Common geometry */
 		std::shared_ptr<std::vector<uint8_t>>          node_values_;      /* Octree node sequence */
-		std::shared_ptr<std::vector<common::ColorYUV>> coefficients_;     /* RAHT result coefficients */
+		std::vector<float>                             coefficients_;     /* RAHT result coefficients, Y/U/V planes in coding order, reused by all slices */
+		std::vector<int32_t>                           int_coefficients_; /* Fixed-point coefficients of integer RAHT slices, same layout as coefficients_ */
 		std::shared_ptr<std::vector<common::ColorYUV>> reference_colors_; /* Reference ColorYUV */
 		std::shared_ptr<std::vector<common::ColorYUV>> source_colors_;    /* Result ColorYUV, after invert compensation */
 		common::Slice                                  slice_;            /* Slice to be decoded */
+		std::vector<common::FIX_DATA_INT>              symbols_;          /* RLGR decoding buffer, Y/U/V planes of coefficients down to lod_depth_, reused by all slices */
+		std::vector<common::FIX_DATA_INT>              level_symbols_;    /* Decoding buffer of one non-split level substream */
+		std::vector<uint8_t>                           contexts_;         /* Context of each RAHT coefficient, built with octree */
 
 		/*
-		 * @description : Back root traversal of octree, compute center and update weight.
-		 * @param  : {const int _height}
-		 * @param  : {const int _index}
-		 * @param  : {const pcl::PointXYZ _center}
-		 * @param  : {const pcl::PointXYZ _range}
+		 * @description : Level order traversal of octree, compute centers layer by layer down to lod_depth_ into source_cloud_, then update weight from leaves to root.
+		 * Points are in layer order, same as a depth-first traversal.
+		 * @param  : {}
+		 * @return : {}
+		 * */
+		void AddPoints();
+
+		/*
+		 * @description : Decode a color stream of Y/U/V planes, split or not, into symbols_, plane c is written from c * _stride + _offset
+		 * @param  : {const uint8_t* _data}
+		 * @param  : {size_t _length}
+		 * @param  : {const uint8_t* _context} _size elements, used by arithmetic coder
+		 * @param  : {size_t _offset}
+		 * @param  : {size_t _size} coefficients of each plane in this stream
+		 * @param  : {size_t _stride} plane size of symbols_
+		 * @return : {}
+		 * */
+		void DecodePlanes(const uint8_t* _data, size_t _length, const uint8_t* _context, size_t _offset, size_t _size, size_t _stride);
+
+		/*
+		 * @description : Decode one channel substream of a split color stream, by RLGR or arithmetic coder
+		 * @param  : {const uint8_t* _data}
+		 * @param  : {size_t _length}
+		 * @param  : {const uint8_t* _context} _size elements, used by arithmetic coder
+		 * @param  : {common::FIX_DATA_INT* _result}
+		 * @param  : {size_t _size}
 		 * @return : {}
 		 * */
-		void AddPoints(const int _height, const int _index, const pcl::PointXYZ _center, const pcl::PointXYZ _range);
+		void DecodeChannel(const uint8_t* _data, size_t _length, const uint8_t* _context, common::FIX_DATA_INT* _result, size_t _size);
 
 	  public:
 		/* Default constructor and deconstructor */
@@ -328,14 +582,14 @@ namespace octree {
 		virtual ~InvertRAHTOctree() = default;
 
 		/*
-		 * @description : Set decoded Slice
+		 * @description : Set decoded Slice, color payload is skipped if decode.geometry_only is set, octree is cut at depth decode.lod if it is not 0, skip slice takes colors of reference
 		 * @param  : {const common::Slice& _slice}
 		 * @return : {}
 		 * */
 		void SetSlice(const common::Slice& _slice);
 
 		/*
-		 * @description : Get result Patch
+		 * @description : Get result Patch, one point per node at decoded depth, all points are black if decode.geometry_only is set
 		 * @param  : {}
 		 * @return : {common::Patch}
 		 * */
@@ -21,6 +21,7 @@
 #include "common/parameter.h"
 #include "common/statistic.h"
 
+#include "io/slice_io.h"
 #include "octree/octree.h"
 #include "registration/registration.h"
 
@@ -125,6 +126,65 @@ namespace patch {
         std::pair<float, float> GetStat() const;
 	};
 
+	/*
+	 * Class VoxelHash, k nearest neighbors search on a hashed voxel grid, built by one sort instead of a kd-tree.
+	 * Points are sorted by cell and an open addressing table maps each occupied cell to its points. A query scans cubic shells
+	 * of cells around the query cell and stops when no point outside the scanned cells can be nearer than the k-th one.
+	 * How to use?
+	 * VoxelHash grid;
+	 * grid.SetInputCloud(cloud, cell);
+	 * grid.NearestKSearch(point, k, idx, dis);
+	 * */
+	class VoxelHash {
+	  private:
+		pcl::PointCloud<pcl::PointXYZRGB>::Ptr cloud_;    /* Indexed points */
+		float                                  cell_;     /* Edge length of a cell */
+		std::vector<int>                       order_;    /* Point indexes sorted by cell */
+		std::vector<pcl::PointXYZ>             points_;   /* Coordinates in order_ */
+		std::vector<uint64_t>                  keys_;     /* Packed cell coordinates of each table slot, VOXEL_HASH_EMPTY if empty */
+		std::vector<std::pair<int, int>>       ranges_;   /* Range of order_ in each table slot */
+		uint64_t                               mask_;     /* Table size - 1, size is a power of two */
+		int                                    lower_[3]; /* Min cell coordinates of points */
+		int                                    upper_[3]; /* Max cell coordinates of points */
+
+		/*
+		 * @description : Table slot of a cell, nullptr if the cell is empty
+		 * @param  : {uint64_t _key}
+		 * @return : {const std::pair<int, int>*}
+		 * */
+		const std::pair<int, int>* Find(uint64_t _key) const;
+
+	  public:
+		/* Default constructor and deconstructor */
+		VoxelHash();
+
+		~VoxelHash() = default;
+
+		/*
+		 * @description : Build grid of _cloud, _cloud must not be changed while the grid is used
+		 * @param  : {const pcl::PointCloud<pcl::PointXYZRGB>::Ptr& _cloud}
+		 * @param  : {float _cell} edge length of a cell
+		 * @return : {}
+		 * */
+		void SetInputCloud(const pcl::PointCloud<pcl::PointXYZRGB>::Ptr& _cloud, float _cell);
+
+		/*
+		 * @description : Search k nearest neighbors of _point, same output as pcl::search::KdTree::nearestKSearch except for order of ties
+		 * @param  : {const pcl::PointXYZRGB& _point}
+		 * @param  : {int _k}
+		 * @param  : {std::vector<int>& _idx} indexes of neighbors, nearest first, smaller index first if distances are equal
+		 * @param  : {std::vector<float>& _dis} squared distances of neighbors
+		 * @return : {int} neighbors number, less than _k only if cloud has less points
+		 * */
+		int NearestKSearch(const pcl::PointXYZRGB& _point, int _k, std::vector<int>& _idx, std::vector<float>& _dis) const;
+	};
+
+	/* Rate control, n nonzero ones of N quantized coefficients are modeled as n * (RATE_NONZERO_BYTES + RATE_POSITION_BYTES * log2(N / n)) bytes */
+	static float RATE_NONZERO_BYTES  = 0.53f; /* Bytes of a nonzero coefficient */
+	static float RATE_POSITION_BYTES = 0.04f; /* Extra bytes of a nonzero coefficient per halving of density, zero runs get longer */
+	static int   RATE_SEARCH_STEPS   = 24;    /* Bisection steps of the common scale of QPs */
+	static int   RATE_PASSES         = 2;     /* Max rounds of first pass, a round only codes slices whose QP has moved */
+
 	/*
 	 * Class GoPEncoding, encode a GoP.
 	 * How to use?
@@ -132,6 +192,7 @@ namespace patch {
 	 * enc.SetParams(param);
 	 * enc.SetFittingCloud(cloud_ptr);
 	 * enc.SetSourcePatches(patches);
+	 * enc.SetRateBudget(bytes); (optional)
 	 * result = enc.GetResults();
 	 * */
 	class GoPEncoding {
@@ -144,6 +205,8 @@ namespace patch {
 		pcl::PointCloud<pcl::PointXYZRGB>::Ptr                      fitting_cloud_;  /* Common geometry */
 		std::vector<common::Patch>                                  source_patches_; /* Source patches */
 		std::vector<std::shared_ptr<std::vector<common::ColorYUV>>> patch_colors_;   /* Interpolated colors */
+		common::EncoderStat_t                                       stat_;           /* Zstd decisions and coded size */
+		float                                                       budget_;         /* Bytes of all slices under rate control, 0 means fixed QPs */
 
 		/*
 		 * @description : Color interpolation.
@@ -181,6 +244,13 @@ namespace patch {
 		 * */
 		void SetSourcePatches(std::vector<common::Patch> _patches);
 
+		/*
+		 * @description : Set bytes of all slices of this GoP, QPs are scaled from slice.qp_i and slice.qp_p to fit it, 0 means fixed QPs.
+		 * @param  : {float _bytes}
+		 * @return : {}
+		 * */
+		void SetRateBudget(float _bytes);
+
 		/*
 		 * @description : Encode this GoP.
 		 * */
@@ -193,6 +263,13 @@ namespace patch {
 		 * */
 		std::vector<common::Slice> GetResults();
 
+		/*
+		 * @description : Get statistic of Zstd decisions and coded size.
+		 * @param  : {}
+		 * @return : {common::EncoderStat_t}
+		 * */
+		common::EncoderStat_t GetStat() const;
+
         using Ptr = std::shared_ptr<patch::GoPEncoding>;
 	};
 }  // namespace patch
@@ -14,9 +14,11 @@
 
 #include "codec/pvvc_encoder.h"
 
+#include <zdict.h>
+
 namespace vvc {
 namespace codec {
-	PVVCCompression::PVVCCompression() : params_{}, clock_{}, gops_{}, results_{}, task_queue_{} {}
+	PVVCCompression::PVVCCompression() : params_{}, clock_{}, gops_{}, results_{}, stat_{}, budgets_{}, task_queue_{} {}
 
 	void PVVCCompression::SetParams(common::PVVCParam_t::Ptr _param) {
 		try {
@@ -57,8 +59,14 @@ namespace codec {
 				enc.SetParams(this->params_);
 				enc.SetFittingCloud(this->gops_[patch_idx][i].cloud);
 				enc.SetSourcePatches(this->gops_[patch_idx][i].patches);
+				if (!this->budgets_[patch_idx].empty()) {
+					enc.SetRateBudget(this->budgets_[patch_idx][i]);
+				}
 				enc.Encode();
 				auto res = enc.GetResults();
+				this->stat_mutex_.lock();
+				this->stat_ += enc.GetStat();
+				this->stat_mutex_.unlock();
 				for (auto& p : res) {
 					int frame_idx = (p.timestamp - this->params_->start_timestamp) / this->params_->time_interval;
 					this->results_[frame_idx][p.index] = p;
@@ -110,20 +118,46 @@ namespace codec {
 				}
 			}
 
-			this->threads_.resize(this->params_->thread_num);
 			this->results_.resize(this->params_->frames, std::vector<common::Slice>(this->gops_.size()));
-			for (int i = 0; i < this->gops_.size(); ++i) {
-				this->task_queue_.push(i);
-			}
 
-			for (auto& i : this->threads_) {
-				i = std::thread(&PVVCCompression::Task, this);
+			/* Rate control, bytes of a frame at target bitrate are shared by GoPs covering it in proportion to their points */
+			this->budgets_.assign(this->gops_.size(), std::vector<float>());
+			if (this->params_->rate.target_kbps > 0.0f) {
+				auto frame_idx = [this](const common::Patch& _p) {
+					int idx = (_p.timestamp - this->params_->start_timestamp) / this->params_->time_interval;
+					if (idx < 0 || idx >= this->params_->frames) {
+						throw __EXCEPT__(OUT_OF_RANGE);
+					}
+					return idx;
+				};
+				std::vector<size_t> frame_points(this->params_->frames, 0);
+				for (const auto& patch_gops : this->gops_) {
+					for (const auto& g : patch_gops) {
+						for (const auto& p : g.patches) {
+							frame_points[frame_idx(p)] += g.cloud->size();
+						}
+					}
+				}
+				const double frame_bytes = this->params_->rate.target_kbps * 1000.0 / 8.0 / 30.0;
+				for (int i = 0; i < this->gops_.size(); ++i) {
+					this->budgets_[i].resize(this->gops_[i].size());
+					for (int j = 0; j < this->gops_[i].size(); ++j) {
+						double bytes = 0.0;
+						for (const auto& p : this->gops_[i][j].patches) {
+							bytes += frame_bytes * this->gops_[i][j].cloud->size() / frame_points[frame_idx(p)];
+						}
+						this->budgets_[i][j] = bytes;
+					}
+				}
 			}
 
-			for (auto& i : this->threads_) {
-				i.join();
+			for (int i = 0; i < this->gops_.size(); ++i) {
+				this->task_queue_.push(i);
 			}
 
+			/* Tasks run on the process-wide pool, so frames of the last GoPs are picked up by threads which run out of GoPs */
+			common::WorkerPool::Global(this->params_->thread_num).ParallelFor(this->params_->thread_num, [this](size_t) { this->Task(); });
+
 			this->clock_.SetTimeEnd();
 			boost::format fmt_1{"\033[%1%m-------------------------------------------------------------------\n"
 			                    "Compression finished\n"
@@ -273,7 +307,8 @@ namespace codec {
 			outfile << this->params_->io.sequence_name << '\n' << this->results_.size() << '\n';
 			outfile.close();
 
-			int total_cnt{};
+			int              total_cnt{};
+			std::vector<int> frame_size(this->results_.size());
 
 			/* For each frame */
 			for (int i = 0; i < this->results_.size(); ++i) {
@@ -312,6 +347,7 @@ namespace codec {
 				std::cout << fmt_frame;
 
 				total_cnt += frame_cnt;
+				frame_size[i] = frame_cnt;
 			}
 
 			boost::format fmt_total{"\033[%1%mSave all slices of all frames, total size \033[0m%2$.2fMB %3$.2fMbps\n"};
@@ -320,6 +356,118 @@ namespace codec {
 			fmt_total % common::AZURE % (total_cnt / 1024.0f / 1024.0f) % bit_rate;
 
 			std::cout << fmt_total;
+
+			this->SaveReport(total_cnt);
+			if (this->params_->rate.target_kbps > 0.0f) {
+				this->SaveRateReport(frame_size);
+			}
+		}
+		catch (const common::Exception& e) {
+			e.Log();
+			throw __EXCEPT__(ERROR_OCCURED);
+		}
+	}
+
+	void PVVCCompression::SaveReport(size_t _total) {
+		try {
+			if (!this->params_) {
+				throw __EXCEPT__(EMPTY_PARAMS);
+			}
+			if (this->results_.empty()) {
+				throw __EXCEPT__(EMPTY_RESULT);
+			}
+
+			std::string name = this->params_->io.result_file;
+			if (name.back() != '/') {
+				name += '/';
+			}
+			name += "encoder_report.txt";
+
+			/* One line for each run, so that presets can be compared in the same file */
+			struct stat info;
+			bool        exist = stat(name.c_str(), &info) == 0;
+
+			std::ofstream outfile;
+			outfile.open(name, std::ios::app);
+			if (!outfile.is_open()) {
+				throw __EXCEPT__(FILE_WRITE_ERROR);
+			}
+			if (!exist) {
+				outfile << "sequence preset zstd_level frames time(s) fps geometry(KB) color(KB) total(KB) bitrate(Mbps) zstd_tried zstd_skipped zstd_used skip_slices\n";
+			}
+
+			const char* preset[] = {"custom", "fast", "balanced", "archival"};
+			float       time     = this->clock_.GetTimeS();
+			float       bit_rate = _total * 8.0f * 30.0f / this->results_.size() / 1000000.0f;
+
+			boost::format fmt_0{"%s %s %d %d %.2f %.2f %.2f %.2f %.2f %.2f %d %d %d %d\n"};
+			fmt_0 % this->params_->io.sequence_name % preset[this->params_->preset.type] % this->params_->zstd_level % this->results_.size() % time %
+			    (this->results_.size() / time) % (this->stat_.geometry / 1024.0f) % (this->stat_.color / 1024.0f) % (_total / 1024.0f) % bit_rate % this->stat_.zstd_tried %
+			    this->stat_.zstd_skipped % this->stat_.zstd_used % this->stat_.skip_slices;
+			outfile << fmt_0;
+			outfile.close();
+
+			boost::format fmt_1{"\033[%1%mPreset \033[0m%2% \033[%1%m: \033[0m%3$.2f \033[%1%mfps, \033[0m%4$.2fMbps\033[%1%m, Zstd tried/skipped/used \033[0m%5%/%6%/%7%\033[%1%m, skip slices \033[0m%8%\n"
+			                    "\t\033[%1%mReport is appended to \033[0m%9%\n"};
+			fmt_1 % common::AZURE % preset[this->params_->preset.type] % (this->results_.size() / time) % bit_rate % this->stat_.zstd_tried % this->stat_.zstd_skipped %
+			    this->stat_.zstd_used % this->stat_.skip_slices % name;
+			std::cout << fmt_1;
+		}
+		catch (const common::Exception& e) {
+			e.Log();
+			throw __EXCEPT__(ERROR_OCCURED);
+		}
+	}
+
+	void PVVCCompression::SaveRateReport(const std::vector<int>& _frame_size) {
+		try {
+			if (!this->params_) {
+				throw __EXCEPT__(EMPTY_PARAMS);
+			}
+			if (_frame_size.empty()) {
+				throw __EXCEPT__(EMPTY_RESULT);
+			}
+
+			std::string name = this->params_->io.result_file;
+			if (name.back() != '/') {
+				name += '/';
+			}
+			name += "rate_report.txt";
+
+			std::ofstream outfile;
+			outfile.open(name);
+			if (!outfile.is_open()) {
+				throw __EXCEPT__(FILE_WRITE_ERROR);
+			}
+			outfile << "second frames target(kbps) achieved(kbps) error(%)\n";
+
+			/* Each second of content is 30 frames, the last one may be shorter */
+			const float target = this->params_->rate.target_kbps;
+			float       max_err{}, sum_err{};
+			int         seconds{};
+			for (size_t start = 0; start < _frame_size.size(); start += 30, ++seconds) {
+				const size_t end   = std::min(start + 30, _frame_size.size());
+				const size_t bytes = std::accumulate(_frame_size.begin() + start, _frame_size.begin() + end, size_t{0});
+				const float  kbps  = bytes * 8.0f * 30.0f / (end - start) / 1000.0f;
+				const float  err   = (kbps - target) / target * 100.0f;
+				max_err            = std::max(max_err, std::abs(err));
+				sum_err += std::abs(err);
+
+				boost::format fmt_0{"%d %d %.2f %.2f %.2f\n"};
+				fmt_0 % seconds % (end - start) % target % kbps % err;
+				outfile << fmt_0;
+			}
+			const size_t total = std::accumulate(_frame_size.begin(), _frame_size.end(), size_t{0});
+			const float  kbps  = total * 8.0f * 30.0f / _frame_size.size() / 1000.0f;
+			boost::format fmt_1{"all %d %.2f %.2f %.2f\n"};
+			fmt_1 % _frame_size.size() % target % kbps % ((kbps - target) / target * 100.0f);
+			outfile << fmt_1;
+			outfile.close();
+
+			boost::format fmt_2{"\033[%1%mRate control target \033[0m%2$.2fkbps\033[%1%m, achieved \033[0m%3$.2fkbps\033[%1%m, per second error mean/max \033[0m%4$.2f%%/%5$.2f%%\n"
+			                    "\t\033[%1%mReport is saved to \033[0m%6%\n"};
+			fmt_2 % common::AZURE % target % kbps % (sum_err / seconds) % max_err % name;
+			std::cout << fmt_2;
 		}
 		catch (const common::Exception& e) {
 			e.Log();
@@ -446,5 +594,108 @@ namespace codec {
 			std::cout << "Save frame " << frame << '\n';
 		}
 	}
+
+	void TrainDictionaries(common::PVVCParam_t::Ptr _param) {
+		try {
+			if (!_param) {
+				throw __EXCEPT__(EMPTY_PARAMS);
+			}
+			if (_param->io.geometry_dict.empty() || _param->io.color_dict.empty()) {
+				std::cout << __REDT__([Error]) << " Missing key parameter geometry_dict or color_dict.\n";
+				throw __EXCEPT__(EMPTY_PARAMS);
+			}
+
+			/* Max size of each dictionary */
+			const size_t dict_capacity = 64 * 1024;
+
+			std::string dirs = _param->io.result_file;
+			if (dirs.back() != '/') {
+				dirs += '/';
+			}
+			dirs += "slice";
+
+			std::ifstream infile;
+			std::string   seq_name;
+			int           frame_cnt{};
+			infile.open(dirs + "/.config");
+			infile >> seq_name >> frame_cnt;
+			infile.close();
+
+			/* Slices coded with previous dictionaries need them to be decoded */
+			if (std::filesystem::exists(_param->io.geometry_dict) && std::filesystem::exists(_param->io.color_dict)) {
+				common::ZstdDictionary::Init().Load(_param);
+			}
+
+			/* Training samples, payloads before Zstd are concatenated, 0 geometry 1 color */
+			std::vector<uint8_t> samples[2];
+			std::vector<size_t>  sample_sizes[2];
+			std::regex           format{"^.*_time_[0-9]+_slice_[0-9]+\\.slice$"};
+
+			for (int f = 0; f < frame_cnt; ++f) {
+				boost::format sub_dir_fmt{"%s/%s_%04d"};
+				sub_dir_fmt % dirs % seq_name % f;
+				std::filesystem::path dir_path{sub_dir_fmt.str()};
+				if (!std::filesystem::is_directory(dir_path)) {
+					throw __EXCEPT__(INVALID_DIR);
+				}
+
+				for (const auto& i : std::filesystem::directory_iterator{dir_path}) {
+					std::string file_name{i.path().c_str()};
+					if (!std::regex_match(file_name, format)) {
+						continue;
+					}
+					common::Slice slice;
+					io::LoadSlice(slice, file_name);
+
+					std::shared_ptr<std::vector<uint8_t>> payload[2] = {slice.geometry, slice.color};
+					bool zstd[2] = {common::CheckSliceType(slice.type, common::PVVC_SLICE_TYPE_GEO_ZSTD), common::CheckSliceType(slice.type, common::PVVC_SLICE_TYPE_COLOR_ZSTD)};
+					for (int k = 0; k < 2; ++k) {
+						if (!payload[k]) {
+							continue;
+						}
+						if (zstd[k]) {
+							common::ZstdDecoder dec;
+							dec.Decode(payload[k]);
+							payload[k] = dec.GetResult();
+						}
+						samples[k].insert(samples[k].end(), payload[k]->begin(), payload[k]->end());
+						sample_sizes[k].emplace_back(payload[k]->size());
+					}
+				}
+			}
+
+			std::string names[2] = {_param->io.geometry_dict, _param->io.color_dict};
+			for (int k = 0; k < 2; ++k) {
+				std::vector<uint8_t> dict(dict_capacity);
+				size_t dict_size = ZDICT_trainFromBuffer(dict.data(), dict.size(), samples[k].data(), sample_sizes[k].data(), sample_sizes[k].size());
+				if (ZDICT_isError(dict_size)) {
+					std::cout << __REDT__([Error]) << ' ' << ZDICT_getErrorName(dict_size) << '\n';
+					throw __EXCEPT__(ZSTD_ERROR);
+				}
+
+				FILE* fp = fopen(names[k].c_str(), "wb");
+				if (fp == nullptr) {
+					switch (errno) {
+						case ENOENT: throw __EXCEPT__(FILE_NOT_EXIST); break;
+						case EACCES: throw __EXCEPT__(PERMISSION_DENIED); break;
+						default: throw __EXCEPT__(UNEXPECTED_FILE_ERROR); break;
+					}
+				}
+				if (fwrite(dict.data(), sizeof(uint8_t), dict_size, fp) != dict_size) {
+					fclose(fp);
+					throw __EXCEPT__(FILE_WRITE_ERROR);
+				}
+				fclose(fp);
+
+				boost::format fmt{"\033[%1%mSave %2% dictionary %3%, %4% bytes trained from %5% payloads.\033[0m\n"};
+				fmt % common::AZURE % (k == 0 ? "geometry" : "color") % names[k] % dict_size % sample_sizes[k].size();
+				std::cout << fmt;
+			}
+		}
+		catch (const common::Exception& e) {
+			e.Log();
+			throw __EXCEPT__(ERROR_OCCURED);
+		}
+	}
 }  // namespace codec
 }  // namespace vvc
@@ -24,6 +24,8 @@ namespace codec {
 				throw __EXCEPT__(EMPTY_PARAMS);
 			}
 			this->params_ = _param;
+			/* Slices coded with dictionaries need them before decoding */
+			common::ZstdDictionary::Init().Load(this->params_);
 		}
 		catch (const common::Exception& e) {
 			e.Log();
@@ -103,11 +105,10 @@ namespace codec {
 	}
 
 	void PVVCDecompression::Decompression() {
-		this->avg_geo = this->avg_y = 0.0f;
+		this->avg_geo = this->avg_y = this->avg_time = 0.0f;
 		this->psnr_cnt = 0;
 		this->patches_.resize(this->slices_.size());
 		this->results_.resize(this->slices_.size(), nullptr);
-		this->threads_.resize(this->params_->thread_num);
 		for (int frame = 0; frame < this->slices_.size(); frame++) {
 			this->patches_[frame].resize(this->slices_[frame].size());
 
@@ -127,15 +128,11 @@ namespace codec {
 				this->task_queue_.push(patch);
 			}
 
-			for (auto& t : this->threads_) {
-				t = std::thread(&PVVCDecompression::Task, this, frame);
-			}
-
-			for (auto& t : this->threads_) {
-				t.join();
-			}
+			/* Tasks run on the process-wide pool, so RAHT and channel decoding of large slices share the same thread_num threads */
+			common::WorkerPool::Global(this->params_->thread_num).ParallelFor(this->params_->thread_num, [this, frame](size_t) { this->Task(frame); });
 			this->results_[frame].reset(new pcl::PointCloud<pcl::PointXYZRGB>());
 			tim.SetTimeEnd();
+			this->avg_time += tim.GetTimeMs();
 			printf("decode frame %d, time %.2fms\n", frame, tim.GetTimeMs());
 
 			for (auto& p : this->patches_[frame]) {
@@ -162,13 +159,26 @@ namespace codec {
 			this->avg_geo += g_mse;
 			this->avg_y += y_mse;
 			this->psnr_cnt++;
-			printf("\tGEO : %.2f   Y : %.2f\n", g_mse, y_mse);
+			/* Decoded points have no color in geometry only mode */
+			if (this->params_->decode.geometry_only) {
+				printf("\tGEO : %.2f\n", g_mse);
+			}
+			else {
+				printf("\tGEO : %.2f   Y : %.2f\n", g_mse, y_mse);
+			}
 		}
 
 		this->avg_geo /= this->psnr_cnt;
 		this->avg_y /= this->psnr_cnt;
+		this->avg_time /= this->psnr_cnt;
 
-		printf("Avg GEO: %.2f\nAvg Y: %.2f\n", this->avg_geo, this->avg_y);
+		if (this->params_->decode.geometry_only) {
+			printf("Avg GEO: %.2f\n", this->avg_geo);
+		}
+		else {
+			printf("Avg GEO: %.2f\nAvg Y: %.2f\n", this->avg_geo, this->avg_y);
+		}
+		printf("Avg decode time: %.2fms\n", this->avg_time);
 	}
 }  // namespace codec
 }  // namespace vvc
@@ -17,33 +17,37 @@
 namespace vvc {
 namespace common {
 
-	RLGREncoder::RLGREncoder() : buffer_{0}, cnt_{0}, result_{} {}
+	RLGREncoder::RLGREncoder() : buffer_{0}, cnt_{0}, stream_{}, size_{0} {}
 
 	void RLGREncoder::Flush() {
-		uint8_t temp;
-		while (this->cnt_ >= BIT_COUNT_8) {
-			this->cnt_ -= BIT_COUNT_8;
-			temp = ((this->buffer_) >> (this->cnt_)) & UINT_LEAST8_MAX;
-			this->result_->emplace_back(temp);
+		if (this->size_ + sizeof(FIX_INT) > this->stream_.size()) {
+			this->stream_.resize(std::max(this->stream_.size() * 2, static_cast<size_t>(BIT_COUNT_8 * sizeof(FIX_INT))));
 		}
+		FIX_INT data = __builtin_bswap64(this->buffer_);
+		memcpy(this->stream_.data() + this->size_, &data, sizeof(FIX_INT));
+		this->size_ += sizeof(FIX_INT);
 	}
 
 	void RLGREncoder::Write(uint8_t _x) {
-		this->buffer_ <<= 1;
-		this->buffer_ |= (_x & 0x01);
-		this->cnt_++;
-		this->Flush();
+		this->Write(static_cast<FIX_INT>(_x & 0x01), 1);
 	}
 
 	void RLGREncoder::Write(FIX_INT _x, int _bits) {
-		if (_bits > (FIX_BIT_COUNT - BIT_COUNT_8)) {
-			this->Write(_x >> (HALF_FIX_BIT_COUNT), _bits - HALF_FIX_BIT_COUNT);
-			this->Write(_x & __MASK__(HALF_FIX_BIT_COUNT), HALF_FIX_BIT_COUNT);
+		if (!_bits) {
 			return;
 		}
-		this->buffer_ = (this->buffer_ << _bits) + _x;
-		this->cnt_ += _bits;
+		int rest = FIX_BIT_COUNT - this->cnt_;
+		if (_bits < rest) {
+			this->buffer_ |= _x << (rest - _bits);
+			this->cnt_ += _bits;
+			return;
+		}
+		/* buffer_ is full, high rest bits of _x fill it, then start a new word */
+		_bits -= rest;
+		this->buffer_ |= _x >> _bits;
 		this->Flush();
+		this->buffer_ = _bits ? _x << (FIX_BIT_COUNT - _bits) : 0;
+		this->cnt_    = _bits;
 	}
 
 	void RLGREncoder::GRWrite(FIX_INT _x, int _bits) {
@@ -58,11 +62,25 @@ namespace common {
 		}
 		else {
 			this->Write(__MASK__(HALF_FIX_BIT_COUNT), HALF_FIX_BIT_COUNT);
-			this->Write(_x, HALF_FIX_BIT_COUNT);
+			this->Write(_x & __MASK__(HALF_FIX_BIT_COUNT), HALF_FIX_BIT_COUNT);
+		}
+	}
+
+	void RLGREncoder::Finish() {
+		if (this->cnt_) {
+			/* Low bits of buffer_ are zero, so only keep the bytes containing valid bits */
+			this->Flush();
+			this->size_ -= sizeof(FIX_INT) - (this->cnt_ + BIT_COUNT_8 - 1) / BIT_COUNT_8;
+			this->buffer_ = 0;
+			this->cnt_    = 0;
 		}
 	}
 
 	void RLGREncoder::Encode(std::shared_ptr<std::vector<FIX_DATA_INT>> _data) {
+		this->Encode(_data->data(), _data->size());
+	}
+
+	void RLGREncoder::Encode(const FIX_DATA_INT* _data, int _size) {
 		this->Reset();
 		FIX_INT u_data;
 		FIX_INT k_P  = 0;
@@ -73,8 +91,8 @@ namespace common {
 		FIX_INT k_R;
 		FIX_INT p;
 
-		for (auto i : *_data) {
-			u_data = Sign2Unsign(i);
+		for (int i = 0; i < _size; ++i) {
+			u_data = Sign2Unsign(_data[i]);
 
 			k   = k_P / L;
 			k_R = k_RP / L;
@@ -107,7 +125,7 @@ namespace common {
 				else {
 					/* Continue run of 0 */
 					++m;
-					if (m == (0x1 << k)) {
+					if (m == (static_cast<FIX_INT>(0x1) << k)) {
 						this->Write(1);
 						/* Adapt k_P */
 						k_P += U1;
@@ -145,20 +163,14 @@ namespace common {
 			this->Write(0);
 			this->Write(m, k_P / L);
 		}
+		this->Finish();
 	}
 
 	std::shared_ptr<std::vector<uint8_t>> RLGREncoder::GetResult() {
-		int r = this->cnt_ % BIT_COUNT_8;
-		if (r) {
-			this->Write(0, BIT_COUNT_8 - r);
-		}
-		else {
-			this->Flush();
-		}
-		return this->result_;
+		return std::make_shared<std::vector<uint8_t>>(this->stream_.begin(), this->stream_.begin() + this->size_);
 	}
 
-	RLGRDecoder::RLGRDecoder() : buffer_{0}, cnt_{0}, now_{}, end_{}, result_{} {}
+	RLGRDecoder::RLGRDecoder() : buffer_{0}, cnt_{0}, now_{}, end_{}, result_{}, word_{0}, word_cnt_{0}, word_pad_{0}, word_now_{nullptr}, word_end_{nullptr} {}
 
 	void RLGRDecoder::Fill() {
 		uint8_t data;
@@ -282,11 +294,693 @@ namespace common {
 		}
 	}
 
+	void RLGRDecoder::WordFill() {
+		if (this->word_cnt_ > FIX_BIT_COUNT - BIT_COUNT_8) {
+			return;
+		}
+		if (this->word_end_ - this->word_now_ >= BIT_COUNT_8) {
+			/* Load eight bytes big-endian, bits behind word_cnt_ are either zero or the same stream bits */
+			FIX_INT data;
+			memcpy(&data, this->word_now_, sizeof(FIX_INT));
+			this->word_ |= __builtin_bswap64(data) >> this->word_cnt_;
+			int bytes = (FIX_BIT_COUNT - 1 - this->word_cnt_) / BIT_COUNT_8;
+			this->word_now_ += bytes;
+			this->word_cnt_ += bytes * BIT_COUNT_8;
+		}
+		else {
+			/* Tail of stream, zero padding */
+			while (this->word_cnt_ <= FIX_BIT_COUNT - BIT_COUNT_8) {
+				FIX_INT data = 0;
+				if (this->word_now_ != this->word_end_) {
+					data = *(this->word_now_++);
+				}
+				else {
+					this->word_pad_ += BIT_COUNT_8;
+				}
+				this->word_ |= data << (FIX_BIT_COUNT - BIT_COUNT_8 - this->word_cnt_);
+				this->word_cnt_ += BIT_COUNT_8;
+			}
+		}
+	}
+
+	FIX_INT RLGRDecoder::WordRead(int _bits) {
+		if (_bits > (FIX_BIT_COUNT - BIT_COUNT_8)) {
+			FIX_INT data = this->WordRead(_bits - HALF_FIX_BIT_COUNT) << HALF_FIX_BIT_COUNT;
+			return data + this->WordRead(HALF_FIX_BIT_COUNT);
+		}
+		if (!_bits) {
+			return 0;
+		}
+		this->WordFill();
+		FIX_INT data = this->word_ >> (FIX_BIT_COUNT - _bits);
+		this->WordSkip(_bits);
+		return data;
+	}
+
+	FIX_INT RLGRDecoder::WordGRRead(int _bits) {
+		this->WordFill();
+		/* Quotient, 1...10, or 32 ones as escape */
+		FIX_INT p = this->WordOnes(HALF_FIX_BIT_COUNT);
+		if (p >= HALF_FIX_BIT_COUNT) {
+			this->WordSkip(HALF_FIX_BIT_COUNT);
+			return this->WordRead(HALF_FIX_BIT_COUNT);
+		}
+		/* Whole codeword is in word_, extract reminder directly, double shift keeps _bits == 0 well-defined */
+		if (p + 1 + _bits < this->word_cnt_) {
+			FIX_INT r = ((this->word_ << p << 1) >> 1) >> (FIX_BIT_COUNT - 1 - _bits);
+			this->WordSkip(p + 1 + _bits);
+			return (p << _bits) + r;
+		}
+		this->WordSkip(p + 1);
+		return (p << _bits) + this->WordRead(_bits);
+	}
+
+	void RLGRDecoder::Decode(std::shared_ptr<std::vector<uint8_t>> _data, FIX_DATA_INT* _result, int _size) {
+		this->Decode(_data->data(), _data->size(), _result, _size);
+	}
+
+	void RLGRDecoder::Decode(const uint8_t* _data, size_t _length, FIX_DATA_INT* _result, size_t _capacity, int _size, size_t& _consumed) {
+		try {
+			if (_size < 0 || static_cast<size_t>(_size) > _capacity) {
+				throw __EXCEPT__(OUT_OF_RANGE);
+			}
+			this->Decode(_data, _length, _result, _size);
+			/* Bits read from stream minus the bits still buffered in word_ */
+			size_t bits = (this->word_now_ - _data) * BIT_COUNT_8 + this->word_pad_ - this->word_cnt_;
+			_consumed   = std::min((bits + BIT_COUNT_8 - 1) / BIT_COUNT_8, _length);
+		}
+		catch (const common::Exception& e) {
+			e.Log();
+			throw __EXCEPT__(ERROR_OCCURED);
+		}
+	}
+
+	void RLGRDecoder::Decode(const uint8_t* _data, size_t _length, FIX_DATA_INT* _result, int _size) {
+		this->word_     = 0;
+		this->word_cnt_ = 0;
+		this->word_pad_ = 0;
+		this->word_now_ = _data;
+		this->word_end_ = _data + _length;
+
+		FIX_INT u_data;
+		FIX_INT k_P  = 0;
+		FIX_INT k_RP = 2 * L;
+		FIX_INT m    = 0;
+
+		FIX_INT k;
+		FIX_INT k_R;
+		FIX_INT p;
+
+		int n = 0;
+		while (n < _size) {
+			k   = k_P / L;
+			k_R = k_RP / L;
+
+			/* Run Length coding */
+			if (k) {
+				m = 0;
+				/* Each leading 1 is a full run of pow(2, k) zeros, k adapts after every 1 */
+				while (true) {
+					this->WordFill();
+					int ones = this->WordOnes(FIX_BIT_COUNT - BIT_COUNT_8);
+					for (int i = 0; i < ones; ++i) {
+						m += static_cast<FIX_INT>(0x1) << k;
+						k_P += U1;
+						k = k_P / L;
+					}
+					if (ones < FIX_BIT_COUNT - BIT_COUNT_8) {
+						this->WordSkip(ones + 1);
+						break;
+					}
+					this->WordSkip(ones);
+				}
+				m += this->WordRead(k);
+				m = std::min(m, static_cast<FIX_INT>(_size - n));
+				std::fill_n(_result + n, m, 0);
+				n += m;
+				if (n >= _size) {
+					break;
+				}
+				u_data       = this->WordGRRead(k_R);
+				_result[n++] = Unsign2Sign(u_data + 1);
+
+				/* Adapt k_RP */
+				p = u_data >> k_R;
+				if (p) {
+					k_RP += p - 1;
+					k_RP = k_RP > HALF_FIX_BIT_COUNT * L ? HALF_FIX_BIT_COUNT * L : k_RP;
+				}
+				else {
+					k_RP = k_RP < 2 ? 0 : k_RP - 2;
+				}
+
+				/* Adapt k_P */
+				k_P = k_P < D1 ? 0 : k_P - D1;
+			}
+			/* No Run Length coding */
+			else {
+				u_data       = this->WordGRRead(k_R);
+				_result[n++] = Unsign2Sign(u_data);
+
+				/* Adapt k_RP */
+				p = u_data >> k_R;
+				if (p) {
+					k_RP = k_RP + p - 1;
+					k_RP = k_RP > HALF_FIX_BIT_COUNT * L ? HALF_FIX_BIT_COUNT * L : k_RP;
+				}
+				else {
+					k_RP = k_RP < 2 ? 0 : k_RP - 2;
+				}
+
+				/* Adapt k_P */
+				if (u_data) {
+					k_P = k_P < D0 ? 0 : k_P - D0;
+				}
+				else {
+					k_P += U0;
+				}
+			}
+		}
+	}
+
 	std::shared_ptr<std::vector<FIX_DATA_INT>> RLGRDecoder::GetResult() {
 		return this->result_;
 	}
 
-	ZstdEncoder::ZstdEncoder() : params_{nullptr}, result_{nullptr} {}
+	ArithmeticEncoder::ArithmeticEncoder() : low_{0}, range_{0xffffffff}, cache_{0}, cache_size_{1}, stream_{}, size_{0} {}
+
+	void ArithmeticEncoder::Reset() {
+		this->low_        = 0;
+		this->range_      = 0xffffffff;
+		this->cache_      = 0;
+		this->cache_size_ = 1;
+		this->size_       = 0;
+	}
+
+	void ArithmeticEncoder::ShiftLow() {
+		/* Top byte is settled if no carry can reach it */
+		if (static_cast<uint32_t>(this->low_) < 0xff000000u || (this->low_ >> 32) != 0) {
+			uint8_t carry = static_cast<uint8_t>(this->low_ >> 32);
+			uint8_t temp  = this->cache_;
+			do {
+				if (this->size_ + 1 > this->stream_.size()) {
+					this->stream_.resize(std::max<size_t>(2 * this->stream_.size(), 1024));
+				}
+				this->stream_[this->size_++] = temp + carry;
+				temp                         = 0xff;
+			} while (--this->cache_size_ != 0);
+			this->cache_ = static_cast<uint8_t>(this->low_ >> 24);
+		}
+		this->cache_size_++;
+		this->low_ = (this->low_ & 0x00ffffff) << 8;
+	}
+
+	void ArithmeticEncoder::EncodeBit(ArithContext_t& _ctx, int _bit) {
+		uint32_t bound = (this->range_ >> ARITH_PROB_BITS) * _ctx.prob;
+		if (!_bit) {
+			this->range_ = bound;
+		}
+		else {
+			this->low_ += bound;
+			this->range_ -= bound;
+		}
+		_ctx.Update(_bit);
+		while (this->range_ < ARITH_RANGE_TOP) {
+			this->range_ <<= 8;
+			this->ShiftLow();
+		}
+	}
+
+	void ArithmeticEncoder::EncodeBypass(FIX_INT _x, int _bits) {
+		for (int i = _bits - 1; i >= 0; --i) {
+			this->range_ >>= 1;
+			if ((_x >> i) & 0x01) {
+				this->low_ += this->range_;
+			}
+			while (this->range_ < ARITH_RANGE_TOP) {
+				this->range_ <<= 8;
+				this->ShiftLow();
+			}
+		}
+	}
+
+	void ArithmeticEncoder::Finish() {
+		for (int i = 0; i < 5; ++i) {
+			this->ShiftLow();
+		}
+		/* Decoder reads zeros beyond the end, trailing zeros are dropped */
+		while (this->size_ > 1 && this->stream_[this->size_ - 1] == 0) {
+			this->size_--;
+		}
+	}
+
+	const uint8_t* ArithmeticEncoder::GetBuffer() const {
+		/* First byte is always zero, it is not stored */
+		return this->stream_.data() + 1;
+	}
+
+	size_t ArithmeticEncoder::GetBufferSize() const {
+		return this->size_ - 1;
+	}
+
+	ArithmeticDecoder::ArithmeticDecoder() : range_{0xffffffff}, code_{0}, now_{nullptr}, end_{nullptr} {}
+
+	uint8_t ArithmeticDecoder::Next() {
+		return this->now_ < this->end_ ? *(this->now_++) : 0;
+	}
+
+	void ArithmeticDecoder::Reset(const uint8_t* _data, size_t _length) {
+		this->now_   = _data;
+		this->end_   = _data + _length;
+		this->range_ = 0xffffffff;
+		this->code_  = 0;
+		for (int i = 0; i < 4; ++i) {
+			this->code_ = (this->code_ << 8) | this->Next();
+		}
+	}
+
+	int ArithmeticDecoder::DecodeBit(ArithContext_t& _ctx) {
+		uint32_t bound = (this->range_ >> ARITH_PROB_BITS) * _ctx.prob;
+		int      bit{};
+		if (this->code_ < bound) {
+			this->range_ = bound;
+			bit          = 0;
+		}
+		else {
+			this->code_ -= bound;
+			this->range_ -= bound;
+			bit = 1;
+		}
+		_ctx.Update(bit);
+		while (this->range_ < ARITH_RANGE_TOP) {
+			this->range_ <<= 8;
+			this->code_ = (this->code_ << 8) | this->Next();
+		}
+		return bit;
+	}
+
+	FIX_INT ArithmeticDecoder::DecodeBypass(int _bits) {
+		FIX_INT ans{};
+		for (int i = 0; i < _bits; ++i) {
+			this->range_ >>= 1;
+			int bit = this->code_ >= this->range_;
+			if (bit) {
+				this->code_ -= this->range_;
+			}
+			ans = (ans << 1) | bit;
+			while (this->range_ < ARITH_RANGE_TOP) {
+				this->range_ <<= 8;
+				this->code_ = (this->code_ << 8) | this->Next();
+			}
+		}
+		return ans;
+	}
+
+	CoefficientEncoder::CoefficientEncoder() : enc_{}, models_{} {}
+
+	void CoefficientEncoder::Encode(const FIX_DATA_INT* _data, const uint8_t* _context, int _size, int _channels) {
+		this->models_.assign(_channels * COEFFICIENT_CONTEXT_NUM, CoefficientModel_t());
+		this->enc_.Reset();
+		for (int c = 0; c < _channels; ++c) {
+			CoefficientModel_t* models = this->models_.data() + c * COEFFICIENT_CONTEXT_NUM;
+			const FIX_DATA_INT* plane  = _data + static_cast<size_t>(c) * _size;
+			/* Magnitude class of previous coefficient, 0/1/more */
+			int prev = 0;
+			for (int i = 0; i < _size; ++i) {
+				CoefficientModel_t& m   = models[_context[i]];
+				FIX_INT             mag = plane[i] < 0 ? -static_cast<FIX_INT>(plane[i]) : static_cast<FIX_INT>(plane[i]);
+				this->enc_.EncodeBit(m.zero[prev], mag != 0);
+				if (!mag) {
+					prev = 0;
+					continue;
+				}
+				this->enc_.EncodeBit(m.sign, plane[i] < 0);
+				/* Unary bins of |x| - 1 */
+				FIX_INT r = mag - 1;
+				int     k = 0;
+				for (; k < COEFFICIENT_MAGNITUDE_BINS; ++k) {
+					int bit = r > static_cast<FIX_INT>(k);
+					this->enc_.EncodeBit(m.magnitude[k], bit);
+					if (!bit) {
+						break;
+					}
+				}
+				/* Escape, 0-order Exp-Golomb, prefix is modeled */
+				if (k == COEFFICIENT_MAGNITUDE_BINS) {
+					FIX_INT x = r - COEFFICIENT_MAGNITUDE_BINS + 1;
+					int     n = FIX_BIT_COUNT - 1 - __builtin_clzll(x);
+					for (int b = 0; b <= n && b < FIX_BIT_COUNT - 1; ++b) {
+						this->enc_.EncodeBit(m.escape[std::min(b, COEFFICIENT_ESCAPE_BINS - 1)], b < n);
+					}
+					this->enc_.EncodeBypass(x, n);
+				}
+				prev = mag == 1 ? 1 : 2;
+			}
+		}
+		this->enc_.Finish();
+	}
+
+	const uint8_t* CoefficientEncoder::GetBuffer() const {
+		return this->enc_.GetBuffer();
+	}
+
+	size_t CoefficientEncoder::GetBufferSize() const {
+		return this->enc_.GetBufferSize();
+	}
+
+	CoefficientDecoder::CoefficientDecoder() : dec_{}, models_{} {}
+
+	void CoefficientDecoder::Decode(const uint8_t* _data, size_t _length, const uint8_t* _context, FIX_DATA_INT* _result, int _size, int _channels) {
+		this->models_.assign(_channels * COEFFICIENT_CONTEXT_NUM, CoefficientModel_t());
+		this->dec_.Reset(_data, _length);
+		for (int c = 0; c < _channels; ++c) {
+			CoefficientModel_t* models = this->models_.data() + c * COEFFICIENT_CONTEXT_NUM;
+			FIX_DATA_INT*       plane  = _result + static_cast<size_t>(c) * _size;
+			int                 prev   = 0;
+			for (int i = 0; i < _size; ++i) {
+				CoefficientModel_t& m = models[_context[i]];
+				if (!this->dec_.DecodeBit(m.zero[prev])) {
+					plane[i] = 0;
+					prev     = 0;
+					continue;
+				}
+				int     negative = this->dec_.DecodeBit(m.sign);
+				FIX_INT r        = 0;
+				while (r < COEFFICIENT_MAGNITUDE_BINS && this->dec_.DecodeBit(m.magnitude[r])) {
+					++r;
+				}
+				if (r == COEFFICIENT_MAGNITUDE_BINS) {
+					int n = 0;
+					while (n < FIX_BIT_COUNT - 1 && this->dec_.DecodeBit(m.escape[std::min(n, COEFFICIENT_ESCAPE_BINS - 1)])) {
+						++n;
+					}
+					FIX_INT x = (static_cast<FIX_INT>(1) << n) | this->dec_.DecodeBypass(n);
+					r         = COEFFICIENT_MAGNITUDE_BINS + x - 1;
+				}
+				FIX_DATA_INT mag = static_cast<FIX_DATA_INT>(r + 1);
+				plane[i]         = negative ? -mag : mag;
+				prev             = mag == 1 ? 1 : 2;
+			}
+		}
+	}
+
+	/* Bits of x/y/z in Morton code of an octree node, subnode k of node n is n * 8 + k */
+	static const uint64_t OCCUPANCY_AXIS[3] = {0x4924924924924924ull, 0x2492492492492492ull, 0x1249249249249249ull};
+
+	/*
+	 * @description : Morton code of the face neighbor of a node
+	 * @param  : {uint64_t _key} Morton code of this node
+	 * @param  : {int _axis} x/y/z
+	 * @param  : {int _positive} 1 for positive direction, 0 for negative direction
+	 * @param  : {int _level} level of this node, root is 0, no more than OCCUPANCY_NEIGHBOR_LEVEL
+	 * @param  : {uint64_t& _result}
+	 * @return : {bool} false if neighbor is out of bounding box
+	 * */
+	static inline bool OccupancyStep(uint64_t _key, int _axis, int _positive, int _level, uint64_t& _result) {
+		uint64_t m    = OCCUPANCY_AXIS[_axis] & ((1ull << (3 * _level)) - 1);
+		uint64_t unit = 4ull >> _axis;
+		uint64_t axis = _key & m;
+		/* Masked add/sub, carry only propagates in bits of this axis */
+		if (_positive) {
+			_result = (((_key | ~m) + unit) & m) | (_key & ~m);
+			return axis != m;
+		}
+		_result = ((axis - unit) & m) | (_key & ~m);
+		return axis != 0;
+	}
+
+	/*
+	 * @description : Check whether a face neighbor of a node is occupied
+	 * @param  : {const std::vector<uint64_t>& _keys} Morton codes of occupied nodes, ascending
+	 * @return : {int}
+	 * */
+	static inline int OccupancyNeighbor(const std::vector<uint64_t>& _keys, uint64_t _key, int _axis, int _positive, int _level) {
+		uint64_t neighbor;
+		return OccupancyStep(_key, _axis, _positive, _level, neighbor) && std::binary_search(_keys.begin(), _keys.end(), neighbor);
+	}
+
+	/*
+	 * Coding state of one node, shared by OccupancyEncoder and OccupancyDecoder.
+	 * Morton code is monotonic in each axis, so the negative neighbors of a subnode are coded before it,
+	 * they are either subnodes of previous nodes or previous subnodes of this node.
+	 * */
+	struct OccupancyNode_t {
+		int      occupied[3][2]; /* Face neighbors of this node, x/y/z, negative/positive */
+		uint64_t key;            /* Morton code of this node */
+		int      level;          /* Level of this node */
+		int      parent;         /* Class of parent occupancy, 0 for root */
+		bool     neighbor;       /* Use neighbors or not */
+
+		OccupancyNode_t(const std::vector<uint64_t>& _keys, uint64_t _key, int _level, uint8_t _parent) : occupied{}, key{_key}, level{_level}, parent{}, neighbor{_level < OCCUPANCY_NEIGHBOR_LEVEL} {
+			int siblings = __builtin_popcount(_parent);
+			this->parent = siblings <= 1 ? 0 : (siblings <= 4 ? 1 : 2);
+			if (this->neighbor) {
+				for (int a = 0; a < 3; ++a) {
+					this->occupied[a][0] = OccupancyNeighbor(_keys, _key, a, 0, _level);
+					this->occupied[a][1] = OccupancyNeighbor(_keys, _key, a, 1, _level);
+				}
+			}
+		}
+
+		/*
+		 * @description : Context index of the _bit-th subnode
+		 * @param  : {int _bit} subnode position
+		 * @param  : {int _ones} occupied subnodes already coded
+		 * @param  : {const std::vector<uint64_t>& _children} occupied subnodes already coded in next level
+		 * @return : {int}
+		 * */
+		int Context(int _bit, int _ones, const std::vector<uint64_t>& _children) const {
+			/* Neighbors of this node on the faces touching this subnode, 3-bit pattern */
+			int adjacent = this->occupied[0][(_bit >> 2) & 1] | this->occupied[1][(_bit >> 1) & 1] << 1 | this->occupied[2][_bit & 1] << 2;
+			/* Coded negative neighbors of this subnode, 3-bit pattern */
+			int coded = 0;
+			if (this->neighbor) {
+				for (int a = 0; a < 3; ++a) {
+					coded |= OccupancyNeighbor(_children, this->key << 3 | _bit, a, 0, this->level + 1) << a;
+				}
+			}
+			return (((_bit * 8 + adjacent) * 8 + coded) * 3 + std::min(_ones, 2)) * 3 + this->parent;
+		}
+	};
+
+	OccupancyEncoder::OccupancyEncoder() : enc_{}, models_{} {}
+
+	void OccupancyEncoder::Encode(const uint8_t* _data, size_t _size, int _levels) {
+		this->models_.assign(OCCUPANCY_CONTEXT_NUM, ArithContext_t());
+		this->enc_.Reset();
+		/* Morton codes and parent occupancy of nodes in this level and next level */
+		std::vector<uint64_t> keys{0}, next_keys;
+		std::vector<uint8_t>  parents{0}, next_parents;
+		size_t                idx = 0;
+		for (int level = 0; level < _levels && idx < _size; ++level) {
+			next_keys.clear(), next_parents.clear();
+			for (size_t n = 0; n < keys.size() && idx < _size; ++n) {
+				uint8_t         mask = _data[idx++];
+				OccupancyNode_t node(keys, keys[n], level, parents[n]);
+				int             ones = 0;
+				for (int k = 0; k < 8; ++k) {
+					int bit = (mask >> (7 - k)) & 1;
+					/* A branch node has at least one subnode */
+					if (k != 7 || ones) {
+						this->enc_.EncodeBit(this->models_[node.Context(k, ones, next_keys)], bit);
+					}
+					if (bit) {
+						++ones;
+						next_keys.emplace_back(keys[n] << 3 | k);
+						next_parents.emplace_back(mask);
+					}
+				}
+			}
+			keys.swap(next_keys), parents.swap(next_parents);
+		}
+		this->enc_.Finish();
+	}
+
+	const uint8_t* OccupancyEncoder::GetBuffer() const {
+		return this->enc_.GetBuffer();
+	}
+
+	size_t OccupancyEncoder::GetBufferSize() const {
+		return this->enc_.GetBufferSize();
+	}
+
+	OccupancyDecoder::OccupancyDecoder() : dec_{}, models_{} {}
+
+	void OccupancyDecoder::Decode(const uint8_t* _data, size_t _length, int _levels, size_t _leaves, std::vector<uint8_t>& _result) {
+		try {
+			this->models_.assign(OCCUPANCY_CONTEXT_NUM, ArithContext_t());
+			this->dec_.Reset(_data, _length);
+			std::vector<uint64_t> keys{0}, next_keys;
+			std::vector<uint8_t>  parents{0}, next_parents;
+			for (int level = 0; level < _levels; ++level) {
+				next_keys.clear(), next_parents.clear();
+				for (size_t n = 0; n < keys.size(); ++n) {
+					OccupancyNode_t node(keys, keys[n], level, parents[n]);
+					uint8_t         mask = 0;
+					int             ones = 0;
+					for (int k = 0; k < 8; ++k) {
+						int bit = k != 7 || ones ? this->dec_.DecodeBit(this->models_[node.Context(k, ones, next_keys)]) : 1;
+						mask    = (mask << 1) | bit;
+						if (bit) {
+							++ones;
+							next_keys.emplace_back(keys[n] << 3 | k);
+						}
+					}
+					next_parents.resize(next_keys.size(), mask);
+					_result.emplace_back(mask);
+				}
+				/* Each level has no more nodes than leaves, otherwise the stream is broken */
+				if (next_keys.size() > _leaves) {
+					throw __EXCEPT__(BAD_SLICE);
+				}
+				keys.swap(next_keys), parents.swap(next_parents);
+			}
+		}
+		catch (const common::Exception& e) {
+			e.Log();
+			throw __EXCEPT__(ERROR_OCCURED);
+		}
+	}
+
+	/*
+	 * @description : Zstandard compression context of this thread
+	 * @return : {ZSTD_CCtx*}
+	 * */
+	static ZSTD_CCtx* ThreadCCtx() {
+		static thread_local std::unique_ptr<ZSTD_CCtx, size_t (*)(ZSTD_CCtx*)> ctx(ZSTD_createCCtx(), ZSTD_freeCCtx);
+		return ctx.get();
+	}
+
+	/*
+	 * @description : Zstandard decompression context of this thread
+	 * @return : {ZSTD_DCtx*}
+	 * */
+	static ZSTD_DCtx* ThreadDCtx() {
+		static thread_local std::unique_ptr<ZSTD_DCtx, size_t (*)(ZSTD_DCtx*)> ctx(ZSTD_createDCtx(), ZSTD_freeDCtx);
+		return ctx.get();
+	}
+
+	ZstdDictionary::ZstdDictionary() : mutex_{}, dicts_{}, id_{}, path_{} {}
+
+	ZstdDictionary::~ZstdDictionary() {
+		for (auto& i : this->dicts_) {
+			ZSTD_freeDDict(i.second.ddict);
+			for (auto& c : i.second.cdicts) {
+				ZSTD_freeCDict(c.second);
+			}
+		}
+	}
+
+	ZstdDictionary& ZstdDictionary::Init() {
+		static ZstdDictionary instance;
+		return instance;
+	}
+
+	void ZstdDictionary::Load(PVVCParam_t::Ptr _param) {
+		try {
+			if (!_param) {
+				throw __EXCEPT__(EMPTY_PARAMS);
+			}
+			std::pair<ZSTD_DICT_TYPE, std::string> files[2] = {{ZSTD_DICT_GEOMETRY, _param->io.geometry_dict}, {ZSTD_DICT_COLOR, _param->io.color_dict}};
+			for (auto& f : files) {
+				if (f.second.empty()) {
+					continue;
+				}
+				{
+					std::lock_guard<std::mutex> lock(this->mutex_);
+					if (this->path_[f.first] == f.second) {
+						continue;
+					}
+				}
+
+				FILE* fp = fopen(f.second.c_str(), "rb");
+				if (fp == nullptr) {
+					switch (errno) {
+						case ENOENT: throw __EXCEPT__(FILE_NOT_EXIST); break;
+						case EACCES: throw __EXCEPT__(PERMISSION_DENIED); break;
+						default: throw __EXCEPT__(UNEXPECTED_FILE_ERROR); break;
+					}
+				}
+				fseek(fp, 0, SEEK_END);
+				long length = ftell(fp);
+				fseek(fp, 0, SEEK_SET);
+				if (length <= 0) {
+					fclose(fp);
+					throw __EXCEPT__(EMPTY_RESULT);
+				}
+				std::vector<uint8_t> dict(length);
+				if (fread(dict.data(), sizeof(uint8_t), dict.size(), fp) != dict.size()) {
+					fclose(fp);
+					throw __EXCEPT__(FILE_READ_ERROR);
+				}
+				fclose(fp);
+
+				this->Add(f.first, dict);
+				std::lock_guard<std::mutex> lock(this->mutex_);
+				this->path_[f.first] = f.second;
+			}
+		}
+		catch (const common::Exception& e) {
+			e.Log();
+			throw __EXCEPT__(ERROR_OCCURED);
+		}
+	}
+
+	void ZstdDictionary::Add(ZSTD_DICT_TYPE _type, const std::vector<uint8_t>& _dict) {
+		try {
+			if (_type == ZSTD_DICT_NONE || _dict.empty()) {
+				throw __EXCEPT__(BAD_PARAMETERS);
+			}
+			/* Only trained dictionary has an ID, raw content dictionary cannot be found by decoder */
+			unsigned int id = ZSTD_getDictID_fromDict(_dict.data(), _dict.size());
+			if (!id) {
+				throw __EXCEPT__(ZSTD_ERROR);
+			}
+
+			std::lock_guard<std::mutex> lock(this->mutex_);
+			if (this->dicts_.find(id) == this->dicts_.end()) {
+				Dict_t& d = this->dicts_[id];
+				d.data    = _dict;
+				d.ddict   = ZSTD_createDDict(d.data.data(), d.data.size());
+				if (!d.ddict) {
+					this->dicts_.erase(id);
+					throw __EXCEPT__(ZSTD_ERROR);
+				}
+			}
+			this->id_[_type] = id;
+		}
+		catch (const common::Exception& e) {
+			e.Log();
+			throw __EXCEPT__(ERROR_OCCURED);
+		}
+	}
+
+	bool ZstdDictionary::Has(ZSTD_DICT_TYPE _type) {
+		std::lock_guard<std::mutex> lock(this->mutex_);
+		return _type != ZSTD_DICT_NONE && this->id_[_type];
+	}
+
+	const ZSTD_CDict* ZstdDictionary::GetCDict(ZSTD_DICT_TYPE _type, int _level) {
+		std::lock_guard<std::mutex> lock(this->mutex_);
+		if (_type == ZSTD_DICT_NONE || !this->id_[_type]) {
+			return nullptr;
+		}
+		Dict_t& d = this->dicts_[this->id_[_type]];
+		/* Digest dictionary once for each level, encoders of all threads share it, so it is never replaced while they may use it */
+		ZSTD_CDict*& cdict = d.cdicts[_level];
+		if (!cdict) {
+			cdict = ZSTD_createCDict(d.data.data(), d.data.size(), _level);
+		}
+		return cdict;
+	}
+
+	const ZSTD_DDict* ZstdDictionary::GetDDict(unsigned int _id) {
+		std::lock_guard<std::mutex> lock(this->mutex_);
+		auto it = this->dicts_.find(_id);
+		return it == this->dicts_.end() ? nullptr : it->second.ddict;
+	}
+
+	ZstdEncoder::ZstdEncoder() : params_{nullptr}, result_{nullptr}, dict_{ZSTD_DICT_NONE} {}
 
 	void ZstdEncoder::SetParams(PVVCParam_t::Ptr _param) {
 		try {
@@ -294,6 +988,49 @@ namespace common {
 				throw __EXCEPT__(EMPTY_PARAMS);
 			}
 			this->params_ = _param;
+			ZstdDictionary::Init().Load(this->params_);
+		}
+		catch (const common::Exception& e) {
+			e.Log();
+			throw __EXCEPT__(ERROR_OCCURED);
+		}
+	}
+
+	void ZstdEncoder::SetDictionary(ZSTD_DICT_TYPE _type) {
+		this->dict_ = _type;
+	}
+
+	/* Bytes of Zstd frame header, block header and literals header */
+	static const size_t ZSTD_ESTIMATE_OVERHEAD = 16;
+
+	bool ZstdEncoder::Estimate(std::shared_ptr<std::vector<uint8_t>> _data) const {
+		try {
+			if (!this->params_) {
+				throw __EXCEPT__(EMPTY_PARAMS);
+			}
+			if (!this->params_->preset.zstd_estimate || ZstdDictionary::Init().Has(this->dict_)) {
+				return true;
+			}
+			if (_data->size() <= ZSTD_ESTIMATE_OVERHEAD) {
+				return false;
+			}
+
+			size_t freq[256]{};
+			for (auto i : *_data) {
+				freq[i]++;
+			}
+
+			/* Huffman literals cost about entropy bits, plus a table description of about 4 bits per symbol */
+			double bits{}, n = static_cast<double>(_data->size());
+			int    symbols{};
+			for (auto i : freq) {
+				if (i) {
+					bits -= i * log2(i / n);
+					symbols++;
+				}
+			}
+			double estimate = bits / 8.0 + symbols / 2.0 + ZSTD_ESTIMATE_OVERHEAD;
+			return estimate < n;
 		}
 		catch (const common::Exception& e) {
 			e.Log();
@@ -311,7 +1048,23 @@ namespace common {
 			int z_level        = this->params_->zstd_level;
 			z_level            = z_level > ZSTD_maxCLevel() ? ZSTD_maxCLevel() : z_level;
 			z_level            = z_level < ZSTD_minCLevel() ? ZSTD_minCLevel() : z_level;
-			size_t result_size = ZSTD_compress(this->result_->data(), buffer_size, _data->data(), _data->size(), z_level);
+
+			const ZSTD_CDict* cdict = ZstdDictionary::Init().GetCDict(this->dict_, z_level);
+			size_t            result_size{};
+			if (cdict) {
+				result_size = ZSTD_compress_usingCDict(ThreadCCtx(), this->result_->data(), buffer_size, _data->data(), _data->size(), cdict);
+			}
+			else if (this->params_->preset.zstd_strategy) {
+				/* Strategy chosen by preset, other parameters follow z_level */
+				ZSTD_CCtx* ctx = ThreadCCtx();
+				ZSTD_CCtx_reset(ctx, ZSTD_reset_session_and_parameters);
+				ZSTD_CCtx_setParameter(ctx, ZSTD_c_compressionLevel, z_level);
+				ZSTD_CCtx_setParameter(ctx, ZSTD_c_strategy, this->params_->preset.zstd_strategy);
+				result_size = ZSTD_compress2(ctx, this->result_->data(), buffer_size, _data->data(), _data->size());
+			}
+			else {
+				result_size = ZSTD_compressCCtx(ThreadCCtx(), this->result_->data(), buffer_size, _data->data(), _data->size(), z_level);
+			}
 			if (ZSTD_isError(result_size) != 0) {
 				throw __EXCEPT__(ZSTD_ERROR);
 			}
@@ -340,18 +1093,63 @@ namespace common {
 
 	void ZstdDecoder::Decode(std::shared_ptr<std::vector<uint8_t>> _data) {
 		try {
-			size_t buffer_size = ZSTD_getFrameContentSize(_data->data(), _data->size());
-
-			if (buffer_size == 0 || buffer_size == ZSTD_CONTENTSIZE_UNKNOWN || buffer_size == ZSTD_CONTENTSIZE_ERROR) {
+			size_t buffer_size = ZstdDecoder::ContentSize(_data->data(), _data->size());
+			if (!buffer_size) {
 				throw __EXCEPT__(ZSTD_ERROR);
 			}
 			this->result_ = std::make_shared<std::vector<uint8_t>>(buffer_size);
 
-			size_t result_size = ZSTD_decompress(this->result_->data(), buffer_size, _data->data(), _data->size());
+			size_t consumed{};
+			this->result_->resize(this->Decode(_data->data(), _data->size(), this->result_->data(), buffer_size, consumed));
+		}
+		catch (const common::Exception& e) {
+			e.Log();
+			throw __EXCEPT__(ERROR_OCCURED);
+		}
+	}
+
+	size_t ZstdDecoder::ContentSize(const uint8_t* _data, size_t _length) {
+		unsigned long long buffer_size = ZSTD_getFrameContentSize(_data, _length);
+		if (buffer_size == ZSTD_CONTENTSIZE_UNKNOWN || buffer_size == ZSTD_CONTENTSIZE_ERROR) {
+			return 0;
+		}
+		return buffer_size;
+	}
+
+	size_t ZstdDecoder::Decode(const uint8_t* _data, size_t _length, uint8_t* _result, size_t _capacity, size_t& _consumed) {
+		try {
+			size_t buffer_size = ZstdDecoder::ContentSize(_data, _length);
+			if (!buffer_size) {
+				throw __EXCEPT__(ZSTD_ERROR);
+			}
+			if (buffer_size > _capacity) {
+				throw __EXCEPT__(OUT_OF_RANGE);
+			}
+
+			/* Only the first frame is decoded, following bytes belong to caller */
+			size_t frame_size = ZSTD_findFrameCompressedSize(_data, _length);
+			if (ZSTD_isError(frame_size) != 0) {
+				throw __EXCEPT__(ZSTD_ERROR);
+			}
+
+			/* Frame compressed with a dictionary carries its ID */
+			unsigned int dict_id = ZSTD_getDictID_fromFrame(_data, frame_size);
+			size_t       result_size{};
+			if (dict_id) {
+				const ZSTD_DDict* ddict = ZstdDictionary::Init().GetDDict(dict_id);
+				if (!ddict) {
+					throw __EXCEPT__(MISSING_DICTIONARY);
+				}
+				result_size = ZSTD_decompress_usingDDict(ThreadDCtx(), _result, _capacity, _data, frame_size, ddict);
+			}
+			else {
+				result_size = ZSTD_decompressDCtx(ThreadDCtx(), _result, _capacity, _data, frame_size);
+			}
 			if (ZSTD_isError(result_size) != 0) {
 				throw __EXCEPT__(ZSTD_ERROR);
 			}
-			this->result_->resize(result_size);
+			_consumed = frame_size;
+			return result_size;
 		}
 		catch (const common::Exception& e) {
 			e.Log();
@@ -14,6 +14,8 @@
 
 #include "common/parameter.h"
 
+#include <zstd.h>
+
 namespace vvc {
 namespace common {
 	PVVCParam_t::Ptr SetDefaultParams() {
@@ -38,7 +40,8 @@ namespace common {
 			p.icp.radius_search_ths  = 10.0f;
 			p.icp.type               = SIMPLE_ICP;
 
-			p.octree.resolution = 1.0f;
+			p.octree.resolution   = 1.0f;
+			p.octree.parallel_ths = 131072;
 
 			p.patch.fitting_ths        = 10.0f;
 			p.patch.max_iter           = 100;
@@ -47,6 +50,12 @@ namespace common {
 			p.patch.interpolation_num  = 10;
 			p.patch.clustering_err_ths = 0.1f;
 
+			p.rate.target_kbps = 0.0f;
+			p.rate.first_pass  = true;
+
+			p.decode.geometry_only = false;
+			p.decode.lod           = 0;
+
 			return std::make_shared<const PVVCParam_t>(p);
 		}
 		catch (const common::Exception& e) {
@@ -133,6 +142,39 @@ namespace common {
 				p.zstd_level = 22;
 			}
 
+			std::string temp_preset;
+			if (!this->cfg_.lookupValue("preset", temp_preset)) {
+				std::cout << __YELLOWT__([Warning]) << ' ' << __AZURET__(preset will be set to custom since it is not in cfg.) << '\n';
+				temp_preset = "custom";
+			}
+			/* Presets override zstd_level, fast and balanced skip Zstd when it is not expected to help */
+			if (temp_preset == "custom") {
+				p.preset.type          = CUSTOM_PRESET;
+				p.preset.zstd_strategy = 0;
+				p.preset.zstd_estimate = false;
+			}
+			else if (temp_preset == "fast") {
+				p.preset.type          = FAST_PRESET;
+				p.zstd_level           = 3;
+				p.preset.zstd_strategy = ZSTD_dfast;
+				p.preset.zstd_estimate = true;
+			}
+			else if (temp_preset == "balanced") {
+				p.preset.type          = BALANCED_PRESET;
+				p.zstd_level           = 12;
+				p.preset.zstd_strategy = ZSTD_lazy2;
+				p.preset.zstd_estimate = true;
+			}
+			else if (temp_preset == "archival") {
+				p.preset.type          = ARCHIVAL_PRESET;
+				p.zstd_level           = 22;
+				p.preset.zstd_strategy = ZSTD_btultra2;
+				p.preset.zstd_estimate = false;
+			}
+			else {
+				throw __EXCEPT__(BAD_PARAMETERS);
+			}
+
 			if (!this->cfg_.lookupValue("max_keyframe", p.max_keyframe)) {
 				std::cout << __YELLOWT__([Warning]) << ' ' << __AZURET__(max_keyframe will be set to 150 since it is not in cfg.) << '\n';
 				p.max_keyframe = 150;
@@ -180,6 +222,10 @@ namespace common {
 				throw __EXCEPT__(EMPTY_PARAMS);
 			}
 
+			/* Optional, Zstd without dictionary if not set */
+			this->cfg_.lookupValue("io.geometry_dict", p.io.geometry_dict);
+			this->cfg_.lookupValue("io.color_dict", p.io.color_dict);
+
 			std::string temp_s;
 
 			if (!this->cfg_.lookupValue("segment.num", p.segment.num)) {
@@ -278,11 +324,112 @@ namespace common {
 				p.slice.qp_p = temp_uint;
 			}
 
+			if (!this->cfg_.lookupValue("slice.split_color", p.slice.split_color)) {
+				std::cout << __YELLOWT__([Warning]) << ' ' << __AZURET__(slice.split_color will be set to true since it is not in cfg.) << '\n';
+				p.slice.split_color = true;
+			}
+
+			if (!this->cfg_.lookupValue("slice.color_coder", temp_s)) {
+				std::cout << __YELLOWT__([Warning]) << ' ' << __AZURET__(slice.color_coder will be set to RLGR_COLOR_CODER since it is not in cfg.) << '\n';
+				p.slice.color_coder = RLGR_COLOR_CODER;
+			}
+			else {
+				if (temp_s == "rlgr") {
+					p.slice.color_coder = RLGR_COLOR_CODER;
+				}
+				else if (temp_s == "arithmetic") {
+					p.slice.color_coder = ARITHMETIC_COLOR_CODER;
+				}
+				else if (temp_s == "auto") {
+					p.slice.color_coder = AUTO_COLOR_CODER;
+				}
+				else {
+					throw __EXCEPT__(BAD_PARAMETERS);
+				}
+			}
+
+			if (!this->cfg_.lookupValue("slice.geometry_coder", temp_s)) {
+				std::cout << __YELLOWT__([Warning]) << ' ' << __AZURET__(slice.geometry_coder will be set to RAW_GEOMETRY_CODER since it is not in cfg.) << '\n';
+				p.slice.geometry_coder = RAW_GEOMETRY_CODER;
+			}
+			else {
+				if (temp_s == "raw") {
+					p.slice.geometry_coder = RAW_GEOMETRY_CODER;
+				}
+				else if (temp_s == "arithmetic") {
+					p.slice.geometry_coder = ARITHMETIC_GEOMETRY_CODER;
+				}
+				else if (temp_s == "auto") {
+					p.slice.geometry_coder = AUTO_GEOMETRY_CODER;
+				}
+				else {
+					throw __EXCEPT__(BAD_PARAMETERS);
+				}
+			}
+
+			if (!this->cfg_.lookupValue("slice.int_raht", p.slice.int_raht)) {
+				std::cout << __YELLOWT__([Warning]) << ' ' << __AZURET__(slice.int_raht will be set to false since it is not in cfg.) << '\n';
+				p.slice.int_raht = false;
+			}
+
+			if (!this->cfg_.lookupValue("slice.level_color", p.slice.level_color)) {
+				std::cout << __YELLOWT__([Warning]) << ' ' << __AZURET__(slice.level_color will be set to false since it is not in cfg.) << '\n';
+				p.slice.level_color = false;
+			}
+
+			if (!this->cfg_.lookupValue("slice.skip_ths", p.slice.skip_ths)) {
+				std::cout << __YELLOWT__([Warning]) << ' ' << __AZURET__(slice.skip_ths will be set to 0 since it is not in cfg.) << '\n';
+				p.slice.skip_ths = 0.0f;
+			}
+			else if (p.slice.skip_ths > 1.0f) {
+				throw __EXCEPT__(BAD_PARAMETERS);
+			}
+
+			if (!this->cfg_.lookupValue("slice.level_step", temp_uint)) {
+				std::cout << __YELLOWT__([Warning]) << ' ' << __AZURET__(slice.level_step will be set to 0 since it is not in cfg.) << '\n';
+				p.slice.level_step = 0;
+			}
+			else if (temp_uint > 32) {
+				throw __EXCEPT__(BAD_PARAMETERS);
+			}
+			else {
+				p.slice.level_step = temp_uint;
+			}
+
+			if (!this->cfg_.lookupValue("slice.dead_zone", p.slice.dead_zone)) {
+				std::cout << __YELLOWT__([Warning]) << ' ' << __AZURET__(slice.dead_zone will be set to 0 since it is not in cfg.) << '\n';
+				p.slice.dead_zone = 0.0f;
+			}
+			else if (p.slice.dead_zone < 0.0f || p.slice.dead_zone > 0.5f) {
+				throw __EXCEPT__(BAD_PARAMETERS);
+			}
+
+			if (!this->cfg_.lookupValue("rate.target_kbps", p.rate.target_kbps)) {
+				std::cout << __YELLOWT__([Warning]) << ' ' << __AZURET__(rate.target_kbps will be set to 0 since it is not in cfg.) << '\n';
+				p.rate.target_kbps = 0.0f;
+			}
+			else if (p.rate.target_kbps < 0.0f) {
+				throw __EXCEPT__(BAD_PARAMETERS);
+			}
+
+			if (!this->cfg_.lookupValue("rate.first_pass", p.rate.first_pass)) {
+				std::cout << __YELLOWT__([Warning]) << ' ' << __AZURET__(rate.first_pass will be set to true since it is not in cfg.) << '\n';
+				p.rate.first_pass = true;
+			}
+
 			if (!this->cfg_.lookupValue("octree.resolution", p.octree.resolution)) {
 				std::cout << __YELLOWT__([Warning]) << ' ' << __AZURET__(octree.resolution will be set to 1.0f since it is not in cfg.) << '\n';
 				p.octree.resolution = 1.0f;
 			}
 
+			if (!this->cfg_.lookupValue("octree.parallel_ths", p.octree.parallel_ths)) {
+				std::cout << __YELLOWT__([Warning]) << ' ' << __AZURET__(octree.parallel_ths will be set to 131072 since it is not in cfg.) << '\n';
+				p.octree.parallel_ths = 131072;
+			}
+			else if (p.octree.parallel_ths < 0) {
+				throw __EXCEPT__(BAD_PARAMETERS);
+			}
+
 			if (!this->cfg_.lookupValue("patch.fitting_ths", p.patch.fitting_ths)) {
 				std::cout << __YELLOWT__([Warning]) << ' ' << __AZURET__(patch.fitting_ths will be set to 10.0f since it is not in cfg.) << '\n';
 				p.patch.fitting_ths = 10.0f;
@@ -327,6 +474,19 @@ namespace common {
 				}
 			}
 
+			if (!this->cfg_.lookupValue("decode.geometry_only", p.decode.geometry_only)) {
+				std::cout << __YELLOWT__([Warning]) << ' ' << __AZURET__(decode.geometry_only will be set to false since it is not in cfg.) << '\n';
+				p.decode.geometry_only = false;
+			}
+
+			if (!this->cfg_.lookupValue("decode.lod", p.decode.lod)) {
+				std::cout << __YELLOWT__([Warning]) << ' ' << __AZURET__(decode.lod will be set to 0 since it is not in cfg.) << '\n';
+				p.decode.lod = 0;
+			}
+			else if (p.decode.lod < 0) {
+				throw __EXCEPT__(BAD_PARAMETERS);
+			}
+
 			return std::make_shared<const PVVCParam_t>(p);
 		}
 		catch (const Exception& e) {
@@ -355,6 +515,15 @@ namespace common {
 
         printf("Launch threads : %d\n", this->thread_num);
         printf("Zstd level : %d\n", this->zstd_level);
+        printf("Encoding preset : ");
+        switch (this->preset.type) {
+            default: printf("--\n"); break;
+            case ENCODE_PRESET::CUSTOM_PRESET: printf("custom\n"); break;
+            case ENCODE_PRESET::FAST_PRESET: printf("fast\n"); break;
+            case ENCODE_PRESET::BALANCED_PRESET: printf("balanced\n"); break;
+            case ENCODE_PRESET::ARCHIVAL_PRESET: printf("archival\n"); break;
+        }
+        printf("Zstd gain estimation : %s\n", this->preset.zstd_estimate ? "Yes" : "No");
         printf("Max interval of keyframe : %d\n", this->max_keyframe);
         printf("Start frame timestamp : %d\n", this->start_timestamp);
         printf("Frames timestamp interval : %d\n", this->time_interval);
@@ -363,6 +532,8 @@ namespace common {
         printf("Source file path : %s\n", this->io.source_file.c_str());
         printf("Buffer file path : %s\n", this->io.segment_file.c_str());
         printf("Result file path : %s\n", this->io.result_file.c_str());
+        printf("Geometry dictionary : %s\n", this->io.geometry_dict.empty() ? "--" : this->io.geometry_dict.c_str());
+        printf("Color dictionary : %s\n", this->io.color_dict.empty() ? "--" : this->io.color_dict.c_str());
         printf("Avg patch point number : %d\n", this->segment.num);
         printf("KNN neighbors : %d\n", this->segment.nn);
         printf("Segment block number : %d\n", static_cast<int>(this->segment.block_num));        
@@ -388,7 +559,40 @@ namespace common {
         printf("Centroid alignment : %s\n", this->icp.centroid_alignment ? "Yes" : "No");
         printf("QP for intra slice : %d\n", this->slice.qp_i);
         printf("QP for predict slice: %d\n", this->slice.qp_p);
+        printf("Split color substreams : %s\n", this->slice.split_color ? "Yes" : "No");
+        printf("Color coder : ");
+        switch (this->slice.color_coder) {
+            default: printf("--\n"); break;
+            case COLOR_CODER_TYPE::RLGR_COLOR_CODER: printf("RLGR\n"); break;
+            case COLOR_CODER_TYPE::ARITHMETIC_COLOR_CODER: printf("arithmetic\n"); break;
+            case COLOR_CODER_TYPE::AUTO_COLOR_CODER: printf("auto, smaller one of RLGR and arithmetic\n"); break;
+        }
+        printf("Geometry coder : ");
+        switch (this->slice.geometry_coder) {
+            default: printf("--\n"); break;
+            case GEOMETRY_CODER_TYPE::RAW_GEOMETRY_CODER: printf("raw\n"); break;
+            case GEOMETRY_CODER_TYPE::ARITHMETIC_GEOMETRY_CODER: printf("arithmetic\n"); break;
+            case GEOMETRY_CODER_TYPE::AUTO_GEOMETRY_CODER: printf("auto, smaller one of raw and arithmetic\n"); break;
+        }
+        printf("Integer RAHT : %s\n", this->slice.int_raht ? "Yes" : "No");
+        printf("Color substream per level : %s\n", this->slice.level_color ? "Yes" : "No");
+        if (this->slice.skip_ths < 0.0f) {
+            printf("Skip slice : off\n");
+        }
+        else {
+            printf("Skip slice threshold : %.4f\n", this->slice.skip_ths);
+        }
+        printf("Level quantization step : %d / 16 octave\n", this->slice.level_step);
+        printf("Quantization dead zone : %.3f\n", this->slice.dead_zone);
+        if (this->rate.target_kbps == 0.0f) {
+            printf("Rate control : off\n");
+        }
+        else {
+            printf("Rate control target : %.2f kbps\n", this->rate.target_kbps);
+            printf("Rate control first pass : %s\n", this->rate.first_pass ? "Yes" : "No");
+        }
         printf("Octree min resolution : %.2f\n", this->octree.resolution);
+        printf("Min leaves of parallel RAHT : %d\n", this->octree.parallel_ths);
         printf("Max fitting MSE : %.2f\n", this->patch.fitting_ths);
         printf("Min clustering resolution : %.2f\n", this->patch.clustering_ths);
         printf("Color interpolation neighbors : %d\n", this->patch.interpolation_num);
@@ -400,6 +604,13 @@ namespace common {
             case SPLIT_TYPE::PLANAR_BISECTION: printf("planar bisection\n"); break;
             case SPLIT_TYPE::PARTIAL_CLUSTERING: printf("partial clustering\n"); break;
         }
+        printf("Decode geometry only : %s\n", this->decode.geometry_only ? "Yes" : "No");
+        if (this->decode.lod == 0) {
+            printf("Decode level of detail : full\n");
+        }
+        else {
+            printf("Decode level of detail : %d\n", this->decode.lod);
+        }
         std::cout << __AZURET__(================================================) << '\n';
 	    PVVCLog_Mutex.unlock();
 	}
@@ -0,0 +1,246 @@
+/* Copyright Notice.
+ *
+ * Please read the LICENSE file in the project root directory for details
+ * of the open source licenses referenced by this source code.
+ *
+ * Copyright: @ChenRP07. All Right Reserved.
+ *
+ * Author        : ChenRP07
+ * Description   : Implement of quantization.h, check it for details.
+ * Create Time   : 2026/10/17 10:12
+ * Last Modified : 2026/10/17 10:12
+ *
+ */
+
+#include "common/quantization.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#	include <immintrin.h>
+#	define _PVVC_QUANT_X86_
+#endif
+
+namespace vvc {
+namespace common {
+
+	/* Coefficients of QuantizeYUV are deinterleaved by blocks of this size */
+	static const size_t QUANT_BLOCK = 1024;
+
+	/* Symbols with larger magnitude are dequantized by scalar code, q * qp then fits in int32 and converts to float exactly as int64 */
+	static const FIX_DATA_INT DEQUANT_SIMD_MAX = (1 << 23) - 1;
+
+	static void QuantizeScalar(const float* _src, FIX_DATA_INT* _dst, size_t _size, int _qp) {
+		float qp = static_cast<float>(_qp);
+		for (size_t i = 0; i < _size; ++i) {
+			_dst[i] = static_cast<FIX_DATA_INT>(std::round(_src[i] / qp));
+		}
+	}
+
+	static void DequantizeScalar(const FIX_DATA_INT* _src, float* _dst, size_t _size, int _qp) {
+		for (size_t i = 0; i < _size; ++i) {
+			_dst[i] = static_cast<float>(_src[i] * _qp);
+		}
+	}
+
+#ifdef _PVVC_QUANT_X86_
+	/* Round half away from zero : t = trunc(q), t += sign(q) if |q - t| >= 0.5, q - t is exact */
+	__attribute__((target("avx2"))) static void QuantizeAVX2(const float* _src, FIX_DATA_INT* _dst, size_t _size, int _qp) {
+		const __m256 qp    = _mm256_set1_ps(static_cast<float>(_qp));
+		const __m256 sign  = _mm256_set1_ps(-0.0f);
+		const __m256 half  = _mm256_set1_ps(0.5f);
+		const __m256 one   = _mm256_set1_ps(1.0f);
+		const __m256 limit = _mm256_set1_ps(2147483648.0f);
+		size_t       i     = 0;
+		for (; i + 8 <= _size; i += 8) {
+			__m256 q = _mm256_div_ps(_mm256_loadu_ps(_src + i), qp);
+			__m256 t = _mm256_round_ps(q, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+			__m256 r = _mm256_cmp_ps(_mm256_andnot_ps(sign, _mm256_sub_ps(q, t)), half, _CMP_GE_OQ);
+			t        = _mm256_add_ps(t, _mm256_and_ps(r, _mm256_or_ps(_mm256_and_ps(q, sign), one)));
+			/* Out of int32 or NaN, leave it to scalar code */
+			if (_mm256_movemask_ps(_mm256_cmp_ps(_mm256_andnot_ps(sign, t), limit, _CMP_NLT_UQ))) {
+				QuantizeScalar(_src + i, _dst + i, 8, _qp);
+				continue;
+			}
+			__m256i n = _mm256_cvttps_epi32(t);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(_dst + i), _mm256_cvtepi32_epi64(_mm256_castsi256_si128(n)));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(_dst + i + 4), _mm256_cvtepi32_epi64(_mm256_extracti128_si256(n, 1)));
+		}
+		QuantizeScalar(_src + i, _dst + i, _size - i, _qp);
+	}
+
+	__attribute__((target("sse4.1"))) static void QuantizeSSE41(const float* _src, FIX_DATA_INT* _dst, size_t _size, int _qp) {
+		const __m128 qp    = _mm_set1_ps(static_cast<float>(_qp));
+		const __m128 sign  = _mm_set1_ps(-0.0f);
+		const __m128 half  = _mm_set1_ps(0.5f);
+		const __m128 one   = _mm_set1_ps(1.0f);
+		const __m128 limit = _mm_set1_ps(2147483648.0f);
+		size_t       i     = 0;
+		for (; i + 4 <= _size; i += 4) {
+			__m128 q = _mm_div_ps(_mm_loadu_ps(_src + i), qp);
+			__m128 t = _mm_round_ps(q, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+			__m128 r = _mm_cmpge_ps(_mm_andnot_ps(sign, _mm_sub_ps(q, t)), half);
+			t        = _mm_add_ps(t, _mm_and_ps(r, _mm_or_ps(_mm_and_ps(q, sign), one)));
+			if (_mm_movemask_ps(_mm_cmpnlt_ps(_mm_andnot_ps(sign, t), limit))) {
+				QuantizeScalar(_src + i, _dst + i, 4, _qp);
+				continue;
+			}
+			__m128i n = _mm_cvttps_epi32(t);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(_dst + i), _mm_cvtepi32_epi64(n));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(_dst + i + 2), _mm_cvtepi32_epi64(_mm_unpackhi_epi64(n, n)));
+		}
+		QuantizeScalar(_src + i, _dst + i, _size - i, _qp);
+	}
+
+	/* Low 32 bits of each int64 are multiplied by qp, valid if all symbols are in [-DEQUANT_SIMD_MAX, DEQUANT_SIMD_MAX] */
+	__attribute__((target("avx2"))) static void DequantizeAVX2(const FIX_DATA_INT* _src, float* _dst, size_t _size, int _qp) {
+		const __m256i qp    = _mm256_set1_epi32(_qp);
+		const __m256i upper = _mm256_set1_epi64x(DEQUANT_SIMD_MAX);
+		const __m256i lower = _mm256_set1_epi64x(-DEQUANT_SIMD_MAX - 1);
+		const __m256i low32 = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+		size_t        i     = 0;
+		for (; i + 8 <= _size; i += 8) {
+			__m256i a   = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_src + i));
+			__m256i b   = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_src + i + 4));
+			__m256i out = _mm256_or_si256(_mm256_or_si256(_mm256_cmpgt_epi64(a, upper), _mm256_cmpgt_epi64(lower, a)),
+			                              _mm256_or_si256(_mm256_cmpgt_epi64(b, upper), _mm256_cmpgt_epi64(lower, b)));
+			if (!_mm256_testz_si256(out, out)) {
+				DequantizeScalar(_src + i, _dst + i, 8, _qp);
+				continue;
+			}
+			__m128i lo = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(a, low32));
+			__m128i hi = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(b, low32));
+			__m256i n  = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+			_mm256_storeu_ps(_dst + i, _mm256_cvtepi32_ps(_mm256_mullo_epi32(n, qp)));
+		}
+		DequantizeScalar(_src + i, _dst + i, _size - i, _qp);
+	}
+
+	__attribute__((target("sse4.1"))) static void DequantizeSSE41(const FIX_DATA_INT* _src, float* _dst, size_t _size, int _qp) {
+		const __m128i qp    = _mm_set1_epi32(_qp);
+		const __m128i upper = _mm_set1_epi32(DEQUANT_SIMD_MAX);
+		const __m128i lower = _mm_set1_epi32(-DEQUANT_SIMD_MAX - 1);
+		size_t        i     = 0;
+		for (; i + 4 <= _size; i += 4) {
+			__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_src + i));
+			__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_src + i + 2));
+			/* Low 32 bits of four symbols, they must sign-extend back to the symbols */
+			__m128i n   = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(2, 0, 2, 0)));
+			__m128i ext = _mm_and_si128(_mm_cmpeq_epi64(_mm_cvtepi32_epi64(n), a), _mm_cmpeq_epi64(_mm_cvtepi32_epi64(_mm_unpackhi_epi64(n, n)), b));
+			__m128i out = _mm_or_si128(_mm_cmpgt_epi32(n, upper), _mm_cmplt_epi32(n, lower));
+			if (_mm_movemask_epi8(ext) != 0xffff || _mm_movemask_epi8(out)) {
+				DequantizeScalar(_src + i, _dst + i, 4, _qp);
+				continue;
+			}
+			_mm_storeu_ps(_dst + i, _mm_cvtepi32_ps(_mm_mullo_epi32(n, qp)));
+		}
+		DequantizeScalar(_src + i, _dst + i, _size - i, _qp);
+	}
+#endif
+
+	using QuantizeFunc   = void (*)(const float*, FIX_DATA_INT*, size_t, int);
+	using DequantizeFunc = void (*)(const FIX_DATA_INT*, float*, size_t, int);
+
+	/*
+	 * @description : Select kernels by CPU features, once per process
+	 * @return : {std::pair<QuantizeFunc, DequantizeFunc>}
+	 * */
+	static std::pair<QuantizeFunc, DequantizeFunc> SelectKernels() {
+#ifdef _PVVC_QUANT_X86_
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2")) {
+			return {QuantizeAVX2, DequantizeAVX2};
+		}
+		if (__builtin_cpu_supports("sse4.1")) {
+			return {QuantizeSSE41, DequantizeSSE41};
+		}
+#endif
+		return {QuantizeScalar, DequantizeScalar};
+	}
+
+	static const std::pair<QuantizeFunc, DequantizeFunc>& Kernels() {
+		static const std::pair<QuantizeFunc, DequantizeFunc> kernels = SelectKernels();
+		return kernels;
+	}
+
+	void Quantize(const float* _src, FIX_DATA_INT* _dst, size_t _size, int _qp) {
+		Kernels().first(_src, _dst, _size, _qp);
+	}
+
+	void Dequantize(const FIX_DATA_INT* _src, float* _dst, size_t _size, int _qp) {
+		Kernels().second(_src, _dst, _size, _qp);
+	}
+
+	void QuantizeYUV(const ColorYUV* _src, FIX_DATA_INT* _dst, size_t _size, int _qp) {
+		/* Deinterleave a block into Y/U/V planes in cache, then quantize each plane */
+		float plane[3][QUANT_BLOCK];
+		for (size_t start = 0; start < _size; start += QUANT_BLOCK) {
+			size_t cnt = std::min(QUANT_BLOCK, _size - start);
+			for (size_t i = 0; i < cnt; ++i) {
+				plane[0][i] = _src[start + i].y;
+				plane[1][i] = _src[start + i].u;
+				plane[2][i] = _src[start + i].v;
+			}
+			for (int c = 0; c < 3; ++c) {
+				Quantize(plane[c], _dst + c * _size + start, cnt, _qp);
+			}
+		}
+	}
+
+	void DequantizeYUV(const FIX_DATA_INT* _src, float* _dst, size_t _size, int _qp) {
+		Dequantize(_src, _dst, 3 * _size, _qp);
+	}
+
+	void QuantizeFixed(const int32_t* _src, FIX_DATA_INT* _dst, size_t _size, int64_t _step) {
+		const int64_t half = _step >> 1;
+		for (size_t i = 0; i < _size; ++i) {
+			int64_t x = _src[i];
+			_dst[i]   = x < 0 ? -((half - x) / _step) : (x + half) / _step;
+		}
+	}
+
+	void DequantizeFixed(const FIX_DATA_INT* _src, int32_t* _dst, size_t _size, int64_t _step) {
+		for (size_t i = 0; i < _size; ++i) {
+			_dst[i] = static_cast<int32_t>(_src[i] * _step);
+		}
+	}
+
+	void QuantizeDeadZone(const float* _src, FIX_DATA_INT* _dst, size_t _size, float _step, float _dead_zone) {
+		const float inv    = 1.0f / _step;
+		const float offset = 0.5f - _dead_zone;
+		for (size_t i = 0; i < _size; ++i) {
+			const FIX_DATA_INT q = static_cast<FIX_DATA_INT>(std::abs(_src[i]) * inv + offset);
+			_dst[i]              = _src[i] < 0.0f ? -q : q;
+		}
+	}
+
+	void DequantizeStep(const FIX_DATA_INT* _src, float* _dst, size_t _size, float _step) {
+		for (size_t i = 0; i < _size; ++i) {
+			_dst[i] = static_cast<float>(_src[i]) * _step;
+		}
+	}
+
+	void QuantizeFixedDeadZone(const int32_t* _src, FIX_DATA_INT* _dst, size_t _size, int64_t _step, int64_t _dead_zone) {
+		const int64_t offset = (_step >> 1) - _dead_zone;
+		for (size_t i = 0; i < _size; ++i) {
+			int64_t x = _src[i];
+			_dst[i]   = x < 0 ? -((offset - x) / _step) : (x + offset) / _step;
+		}
+	}
+
+	float LevelStep(int _qp, uint8_t _level_step, int _height, int _depth) {
+		/* Clamped, so a large level_step of a deep tree never gives a zero or denormal step */
+		return std::max(_qp * std::exp2(-static_cast<float>(_level_step) * (_height - 1 - _depth) / PVVC_SLICE_LEVEL_STEP_UNIT), PVVC_SLICE_MIN_LEVEL_STEP);
+	}
+
+	int64_t LevelStepFixed(int64_t _step, uint8_t _level_step, int _height, int _depth) {
+		/* _step * 2^(-e / 16) = _step * table[e % 16] * 2^(-16 - e / 16), rounded to nearest */
+		const int64_t e     = static_cast<int64_t>(_level_step) * (_height - 1 - _depth);
+		const int64_t shift = 16 + e / 16;
+		/* Shift of int64_t must be less than 64, _step * table[] of an 8-bit qp is far less than 2^62 and rounds to 0 anyway, clamped as well */
+		if (shift >= 62) {
+			return 1;
+		}
+		const int64_t step = (_step * PVVC_SLICE_LEVEL_STEP_TABLE[e % 16] + (int64_t{1} << (shift - 1))) >> shift;
+		return std::max<int64_t>(step, 1);
+	}
+}  // namespace common
+}  // namespace vvc
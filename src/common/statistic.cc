@@ -16,6 +16,16 @@
 
 using namespace vvc;
 
+common::EncoderStat_t& common::EncoderStat_t::operator+=(const common::EncoderStat_t& _x) {
+	this->zstd_tried += _x.zstd_tried;
+	this->zstd_skipped += _x.zstd_skipped;
+	this->zstd_used += _x.zstd_used;
+	this->skip_slices += _x.skip_slices;
+	this->geometry += _x.geometry;
+	this->color += _x.color;
+	return *this;
+}
+
 float common::ParallelICPStat_t::min_score(int type, int idx) {
 	type %= 4;
 	idx %= 2;
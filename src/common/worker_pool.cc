@@ -0,0 +1,148 @@
+/* Copyright Notice.
+ *
+ * Please read the LICENSE file in the project root directory for details
+ * of the open source licenses referenced by this source code.
+ *
+ * Copyright: @ChenRP07, All Right Reserved.
+ *
+ * Author        : ChenRP07
+ * Description   : Implement of WorkerPool, check worker_pool.h for details.
+ * Create Time   : 2026/10/17 16:05
+ * Last Modified : 2026/10/17 16:05
+ *
+ */
+
+#include "common/worker_pool.h"
+#include <algorithm>
+
+namespace vvc {
+namespace common {
+
+	/* Workers starting after the loop is done find no index and never touch func */
+	struct WorkerPool::Loop_t {
+		std::atomic<size_t>                next{0};
+		size_t                             done{0};
+		size_t                             count{0};
+		size_t                             helpers{0}; /* Helper jobs queued so far, only touched by the caller */
+		const std::function<void(size_t)>* func{nullptr};
+		std::exception_ptr                 error{nullptr}; /* First exception thrown by func */
+		std::mutex                         mutex;
+		std::condition_variable            cond;
+	};
+
+	WorkerPool::WorkerPool(int _threads) : workers_{}, jobs_{}, mutex_{}, cond_{}, stop_{false}, free_{static_cast<size_t>(std::max(_threads, 0))} {
+		for (int i = 0; i < _threads; ++i) {
+			this->workers_.emplace_back(&WorkerPool::Work, this);
+		}
+	}
+
+	WorkerPool::~WorkerPool() {
+		{
+			std::lock_guard<std::mutex> lock(this->mutex_);
+			this->stop_ = true;
+		}
+		this->cond_.notify_all();
+		for (auto& t : this->workers_) {
+			t.join();
+		}
+	}
+
+	void WorkerPool::Work() {
+		std::unique_lock<std::mutex> lock(this->mutex_);
+		while (true) {
+			this->cond_.wait(lock, [this] { return this->stop_ || !this->jobs_.empty(); });
+			if (this->jobs_.empty()) {
+				return;
+			}
+			std::function<void()> job = std::move(this->jobs_.front());
+			this->jobs_.pop();
+			lock.unlock();
+			job();
+			job = nullptr;
+			lock.lock();
+			++this->free_;
+		}
+	}
+
+	int WorkerPool::size() const {
+		return this->workers_.size();
+	}
+
+	void WorkerPool::Run(const std::shared_ptr<Loop_t>& _loop, bool _offer) {
+		size_t             finished = 0;
+		std::exception_ptr error{nullptr};
+		for (size_t i = _loop->next++; i < _loop->count; i = _loop->next++) {
+			if (_offer) {
+				this->Offer(_loop);
+			}
+			/* Remaining indexes still run after an exception, so the caller always waits for all of them */
+			try {
+				(*_loop->func)(i);
+			}
+			catch (...) {
+				if (!error) {
+					error = std::current_exception();
+				}
+			}
+			++finished;
+		}
+		if (finished != 0) {
+			std::lock_guard<std::mutex> lock(_loop->mutex);
+			if (error && !_loop->error) {
+				_loop->error = error;
+			}
+			_loop->done += finished;
+			if (_loop->done == _loop->count) {
+				_loop->cond.notify_all();
+			}
+		}
+	}
+
+	void WorkerPool::Offer(const std::shared_ptr<Loop_t>& _loop) {
+		/* Cheap check for each index, nothing is locked while all workers are busy */
+		if (this->free_.load(std::memory_order_relaxed) == 0 || _loop->helpers >= this->workers_.size()) {
+			return;
+		}
+		size_t next = _loop->next.load();
+		if (next >= _loop->count) {
+			return;
+		}
+		size_t helpers = 0;
+		{
+			std::lock_guard<std::mutex> lock(this->mutex_);
+			helpers = std::min({this->free_.load(), _loop->count - next, this->workers_.size() - _loop->helpers});
+			this->free_ -= helpers;
+			for (size_t i = 0; i < helpers; ++i) {
+				this->jobs_.emplace([this, _loop]() { this->Run(_loop, false); });
+			}
+		}
+		_loop->helpers += helpers;
+		for (size_t i = 0; i < helpers; ++i) {
+			this->cond_.notify_one();
+		}
+	}
+
+	void WorkerPool::ParallelFor(size_t _count, const std::function<void(size_t)>& _func) {
+		if (_count == 0) {
+			return;
+		}
+
+		auto loop   = std::make_shared<Loop_t>();
+		loop->count = _count;
+		loop->func  = &_func;
+
+		/* Caller takes part in the loop and offers helpers to workers which become free meanwhile, then waits for indexes taken by workers */
+		this->Run(loop, true);
+		std::unique_lock<std::mutex> lock(loop->mutex);
+		loop->cond.wait(lock, [&loop] { return loop->done == loop->count; });
+		if (loop->error) {
+			std::rethrow_exception(loop->error);
+		}
+	}
+
+	WorkerPool& WorkerPool::Global(int _threads) {
+		static WorkerPool pool(std::max(_threads - 1, 0));
+		return pool;
+	}
+}  // namespace common
+}  // namespace vvc
@@ -46,6 +46,7 @@ namespace client {
 
 		gpuErrchk(cudaMemcpyAsync(CUDAFrame[index].index_gpu, _frame.index, sizeof(int) * _frame.slice_cnt, cudaMemcpyHostToDevice, stream1));
 		gpuErrchk(cudaMemcpyAsync(CUDAFrame[index].type_gpu, _frame.type, sizeof(uint8_t) * _frame.slice_cnt, cudaMemcpyHostToDevice, stream1));
+		gpuErrchk(cudaMemcpyAsync(CUDAFrame[index].ext_gpu, _frame.ext, sizeof(uint8_t) * _frame.slice_cnt, cudaMemcpyHostToDevice, stream1));
 		gpuErrchk(cudaMemcpyAsync(CUDAFrame[index].size_gpu, _frame.size, sizeof(uint32_t) * _frame.slice_cnt, cudaMemcpyHostToDevice, stream1));
 		gpuErrchk(cudaMemcpyAsync(CUDAFrame[index].qp_gpu, _frame.qp, sizeof(uint8_t) * _frame.slice_cnt, cudaMemcpyHostToDevice, stream1));
 		gpuErrchk(cudaMemcpyAsync(CUDAFrame[index].geometry_size_gpu, _frame.geometry_size, sizeof(uint32_t) * _frame.slice_cnt, cudaMemcpyHostToDevice, stream1));
@@ -77,6 +78,7 @@ namespace client {
 			gpuErrchk(cudaMalloc((void**)&(CUDAFrame[i].inner_offset_gpu), sizeof(int) * Manager::PATCH_SIZE));
 			gpuErrchk(cudaMalloc((void**)&(CUDAFrame[i].index_gpu), sizeof(int) * Manager::PATCH_SIZE));
 			gpuErrchk(cudaMalloc((void**)&(CUDAFrame[i].type_gpu), sizeof(uint8_t) * Manager::PATCH_SIZE));
+			gpuErrchk(cudaMalloc((void**)&(CUDAFrame[i].ext_gpu), sizeof(uint8_t) * Manager::PATCH_SIZE));
 			gpuErrchk(cudaMalloc((void**)&(CUDAFrame[i].size_gpu), sizeof(uint32_t) * Manager::PATCH_SIZE));
 			gpuErrchk(cudaMalloc((void**)&(CUDAFrame[i].qp_gpu), sizeof(uint8_t) * Manager::PATCH_SIZE));
 			gpuErrchk(cudaMalloc((void**)&(CUDAFrame[i].geometry_size_gpu), sizeof(uint32_t) * Manager::PATCH_SIZE));
@@ -49,6 +49,28 @@ namespace client {
 				return 6;
 			}
 
+			/* Arithmetic coded color is not supported in client */
+			if (common::CheckSliceType(_slice.type, common::PVVC_SLICE_TYPE_COLOR_ARITH)) {
+				printf("Load %s failed, arithmetic coded color is not supported.\n", _name.c_str());
+				fclose(fp);
+				return 8;
+			}
+
+			/* Extension byte follows type, only integer RAHT is supported in client */
+			_slice.ext = 0;
+			if (common::CheckSliceType(_slice.type, common::PVVC_SLICE_TYPE_EXTEND)) {
+				if (fread(&_slice.ext, sizeof(uint8_t), 1, fp) != 1) {
+					printf("Load %s failed, read error.\n", _name.c_str());
+					fclose(fp);
+					return 5;
+				}
+				if (!common::CheckSliceExtSupported(_slice.type, _slice.ext)) {
+					printf("Load %s failed, extended slice other than integer RAHT is not supported.\n", _name.c_str());
+					fclose(fp);
+					return 8;
+				}
+			}
+
 			if (fread(&_slice.timestamp, sizeof(int), 1, fp) != 1) {
 				printf("Load %s failed, read error.\n", _name.c_str());
 				fclose(fp);
@@ -97,6 +119,12 @@ namespace client {
 					return 5;
 				}
 				if (common::CheckSliceType(_slice.type, common::PVVC_SLICE_TYPE_GEO_ZSTD)) {
+					/* Trained dictionaries are not supported in client */
+					if (ZSTD_getDictID_fromFrame(_slice.geometry, _slice.geometry_size)) {
+						printf("Load %s failed, Zstd dictionary is not supported.\n", _name.c_str());
+						fclose(fp);
+						return 8;
+					}
 					size_t   buffer_size = ZSTD_getFrameContentSize(_slice.geometry, _slice.geometry_size);
 					uint8_t* temp        = new uint8_t[buffer_size];
 					size_t   result_size = ZSTD_decompress(temp, buffer_size, _slice.geometry, _slice.geometry_size);
@@ -124,6 +152,12 @@ namespace client {
 					return 5;
 				}
 				if (common::CheckSliceType(_slice.type, common::PVVC_SLICE_TYPE_COLOR_ZSTD)) {
+					/* Trained dictionaries are not supported in client */
+					if (ZSTD_getDictID_fromFrame(_slice.color, _slice.color_size)) {
+						printf("Load %s failed, Zstd dictionary is not supported.\n", _name.c_str());
+						fclose(fp);
+						return 8;
+					}
 					size_t   buffer_size = ZSTD_getFrameContentSize(_slice.color, _slice.color_size);
 					uint8_t* temp        = new uint8_t[buffer_size];
 					size_t   result_size = ZSTD_decompress(temp, buffer_size, _slice.color, _slice.color_size);
@@ -175,6 +209,7 @@ namespace client {
 
 			_frame.index         = new int[_frame.slice_cnt];
 			_frame.type          = new uint8_t[_frame.slice_cnt];
+			_frame.ext           = new uint8_t[_frame.slice_cnt]{};
 			_frame.size          = new uint32_t[_frame.slice_cnt];
 			_frame.qp            = new uint8_t[_frame.slice_cnt];
 			_frame.mv            = new float*[_frame.slice_cnt];
@@ -195,6 +230,34 @@ namespace client {
 				return 5;
 			}
 
+			/* Extension bytes follow types if any slice is extended */
+			bool extended = false;
+			for (int i = 0; i < _frame.slice_cnt; ++i) {
+				/* Arithmetic coded color is not supported in client */
+				if (common::CheckSliceType(_frame.type[i], common::PVVC_SLICE_TYPE_COLOR_ARITH)) {
+					printf("Load %s failed, arithmetic coded color is not supported.\n", _name.c_str());
+					fclose(fp);
+					return 8;
+				}
+				extended = extended || common::CheckSliceType(_frame.type[i], common::PVVC_SLICE_TYPE_EXTEND);
+			}
+
+			if (extended) {
+				if (fread(_frame.ext, sizeof(uint8_t), _frame.slice_cnt, fp) != _frame.slice_cnt) {
+					printf("Load %s failed, read error.\n", _name.c_str());
+					fclose(fp);
+					return 5;
+				}
+				/* Only integer RAHT is supported in client, so no level step follows qps */
+				for (int i = 0; i < _frame.slice_cnt; ++i) {
+					if (!common::CheckSliceExtSupported(_frame.type[i], _frame.ext[i])) {
+						printf("Load %s failed, extended slice other than integer RAHT is not supported.\n", _name.c_str());
+						fclose(fp);
+						return 8;
+					}
+				}
+			}
+
 			if (fread(_frame.size, sizeof(uint32_t), _frame.slice_cnt, fp) != _frame.slice_cnt) {
 				printf("Load %s failed, read error.\n", _name.c_str());
 				fclose(fp);
@@ -231,6 +294,12 @@ namespace client {
 						return 5;
 					}
 					if (common::CheckSliceType(_frame.type[i], common::PVVC_SLICE_TYPE_GEO_ZSTD)) {
+						/* Trained dictionaries are not supported in client */
+						if (ZSTD_getDictID_fromFrame(_frame.geometry[i], _frame.geometry_size[i])) {
+							printf("Load %s failed, Zstd dictionary is not supported.\n", _name.c_str());
+							fclose(fp);
+							return 8;
+						}
 						size_t   buffer_size = ZSTD_getFrameContentSize(_frame.geometry[i], _frame.geometry_size[i]);
 						uint8_t* temp        = new uint8_t[buffer_size];
 						size_t   result_size = ZSTD_decompress(temp, buffer_size, _frame.geometry[i], _frame.geometry_size[i]);
@@ -256,6 +325,12 @@ namespace client {
 						return 5;
 					}
 					if (common::CheckSliceType(_frame.type[i], common::PVVC_SLICE_TYPE_COLOR_ZSTD)) {
+						/* Trained dictionaries are not supported in client */
+						if (ZSTD_getDictID_fromFrame(_frame.color[i], _frame.color_size[i])) {
+							printf("Load %s failed, Zstd dictionary is not supported.\n", _name.c_str());
+							fclose(fp);
+							return 8;
+						}
 						size_t   buffer_size = ZSTD_getFrameContentSize(_frame.color[i], _frame.color_size[i]);
 						uint8_t* temp        = new uint8_t[buffer_size];
 						size_t   result_size = ZSTD_decompress(temp, buffer_size, _frame.color[i], _frame.color_size[i]);
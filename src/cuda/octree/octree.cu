@@ -44,6 +44,39 @@ namespace octree {
 		return ;
 	}
 
+    /* Integer square root, result does not depend on floating-point precision, same as encoder */
+    __device__ static uint64_t ISqrt(uint64_t _x) {
+        uint64_t r = static_cast<uint64_t>(sqrt(static_cast<double>(_x)));
+        while (r * r > _x) {
+            --r;
+        }
+        while ((r + 1) * (r + 1) <= _x) {
+            ++r;
+        }
+        return r;
+    }
+
+    /* Fixed-point product of a lifting step, rounded to nearest */
+    __device__ static inline int32_t Lift(int32_t _c, int32_t _x) {
+        return static_cast<int32_t>((static_cast<int64_t>(_c) * _x + (static_cast<int64_t>(1) << (common::INT_RAHT_LIFT_BITS - 1))) >> common::INT_RAHT_LIFT_BITS);
+    }
+
+    __device__ void IntInvertHaarTransform(int _w0, int _w1, const int32_t* _g, const int32_t* _h, int32_t* _res0, int32_t* _res1) {
+        /* cos θ and sin θ, then tan(θ / 2) = sin θ / (1 + cos θ), must be bit-exact with encoder */
+        const uint64_t one    = static_cast<uint64_t>(1) << common::INT_RAHT_LIFT_BITS;
+        const uint64_t cosine = ISqrt((static_cast<uint64_t>(_w0) << (2 * common::INT_RAHT_LIFT_BITS)) / (_w0 + _w1));
+        const uint64_t sine   = ISqrt((static_cast<uint64_t>(_w1) << (2 * common::INT_RAHT_LIFT_BITS)) / (_w0 + _w1));
+        const int32_t  p      = static_cast<int32_t>((sine << common::INT_RAHT_LIFT_BITS) / (one + cosine));
+        const int32_t  s      = static_cast<int32_t>(sine);
+        for (int c = 0; c < 3; ++c) {
+            int32_t g = _g[c], h = _h[c];
+            g -= Lift(p, h);
+            h += Lift(s, g);
+            g -= Lift(p, h);
+            _res0[c] = g, _res1[c] = h;
+        }
+    }
+
     __device__ void LoadTreeCore(common::PointXYZ& _center, common::PointXYZ& _range, int& _height, uint8_t (&_p)[25]) {
 		float data[6] = {};
 
@@ -92,22 +125,111 @@ namespace octree {
 		}
 	}
 
+    __device__ void OctreeNode_t::IntInvertHierarchicalTransform() {
+        int32_t H[8][3];
+        for (int i = 0; i < 8; ++i) {
+            for (int c = 0; c < 3; ++c) {
+                H[i][c] = this->int_raht[i][c];
+            }
+        }
+        /* g_DC */
+        for (int c = 0; c < 3; ++c) {
+            this->int_raht[1][c] = H[0][c];
+        }
+        /* Invert X/Y/Z merge */
+        for (int i = 1; i < 8; ++i) {
+            int w0 = this->weight[NodeWeight[i][0]], w1 = this->weight[NodeWeight[i][1]];
+            int32_t* g0 = this->int_raht[NodeWeight[i][0]];
+            int32_t* g1 = this->int_raht[NodeWeight[i][1]];
+            if (w0 != 0 && w1 != 0) {
+                int32_t g[3] = {this->int_raht[i][0], this->int_raht[i][1], this->int_raht[i][2]};
+                IntInvertHaarTransform(w0, w1, g, H[i], g0, g1);
+            }
+            else if (w0 != 0) {
+                for (int c = 0; c < 3; ++c) {
+                    g0[c] = this->int_raht[i][c];
+                }
+            }
+            else if (w1 != 0) {
+                for (int c = 0; c < 3; ++c) {
+                    g1[c] = this->int_raht[i][c];
+                }
+            }
+        }
+    }
+
+    __device__ void InvertRAHTOctree::Dequantize(int _channel, const int64_t* _symbols) {
+        if (common::CheckSliceExt(this->slice_.type, this->slice_.ext, common::PVVC_SLICE_EXT_INT_RAHT)) {
+            /* Fixed-point step, same as encoder */
+            const int64_t step = static_cast<int64_t>(this->slice_.qp) << common::INT_RAHT_FRAC_BITS;
+            for (int i = 0; i < this->slice_.size; ++i) {
+                this->int_coefficients_[3 * i + _channel] = static_cast<int32_t>(_symbols[i] * step);
+            }
+            return;
+        }
+        for (int i = 0; i < this->slice_.size; ++i) {
+            float value = static_cast<float>(_symbols[i] * this->slice_.qp);
+            if (_channel == 0) {
+                this->coefficients_[i].y = value;
+            }
+            else if (_channel == 1) {
+                this->coefficients_[i].u = value;
+            }
+            else {
+                this->coefficients_[i].v = value;
+            }
+        }
+    }
+
     __device__ void InvertRAHTOctree::SetSlice(const common::Slice_t& _slice) {
         this->slice_ = _slice;
         /* Optional Zstd decoding */
         this->node_values_ = this->slice_.geometry;
+        /* Skip slice has no color, residual is zero so colors are the reference ones */
+        if (common::CheckSliceType(this->slice_.type, common::PVVC_SLICE_TYPE_SKIP)) {
+            for (int i = 0; i < this->source_cloud_index_; ++i) {
+                this->source_colors_[i] = this->reference_colors_[i];
+            }
+            return;
+        }
         auto temp_color = this->slice_.color;
-        /* RLGR decoding */
-        common::RLGRDecoder rlgr_dec;
-        rlgr_dec.Decode(temp_color, this->slice_.color_size, 3 * this->slice_.size);
-        auto rlgr_res       = rlgr_dec.GetResult();
         delete [](this->coefficients_);
-        this->coefficients_ = new common::ColorYUV[this->slice_.size];
-        /* Reconstruct coefficients */
-        for (int i = 0; i < this->slice_.size; ++i) {
-            this->coefficients_[i].y = static_cast<float>(rlgr_res[i] * this->slice_.qp);
-            this->coefficients_[i].u = static_cast<float>(rlgr_res[i + this->slice_.size] * this->slice_.qp);
-            this->coefficients_[i].v = static_cast<float>(rlgr_res[i + 2 * this->slice_.size] * this->slice_.qp);
+        delete [](this->int_coefficients_);
+        this->coefficients_     = nullptr;
+        this->int_coefficients_ = nullptr;
+        if (common::CheckSliceExt(this->slice_.type, this->slice_.ext, common::PVVC_SLICE_EXT_INT_RAHT)) {
+            this->int_coefficients_ = new int32_t[3 * this->slice_.size];
+        }
+        else {
+            this->coefficients_ = new common::ColorYUV[this->slice_.size];
+        }
+        if (common::CheckSliceType(this->slice_.type, common::PVVC_SLICE_TYPE_COLOR_SPLIT)) {
+            /* Y U V substreams after size table of Y and U, V takes the rest */
+            uint32_t length[3]{};
+            for (int c = 0; c < 2; ++c) {
+                for (int i = 0; i < 4; ++i) {
+                    length[c] = (length[c] << 8) | temp_color[c * 4 + i];
+                }
+            }
+            length[2] = this->slice_.color_size - common::PVVC_SLICE_COLOR_SPLIT_TABLE - length[0] - length[1];
+            uint8_t* start = temp_color + common::PVVC_SLICE_COLOR_SPLIT_TABLE;
+            for (int c = 0; c < 3; ++c) {
+                /* RLGR decoding, each substream starts with a new adaptive state */
+                common::RLGRDecoder rlgr_dec;
+                rlgr_dec.Decode(start, length[c], this->slice_.size);
+                this->Dequantize(c, rlgr_dec.GetResult());
+                start += length[c];
+            }
+        }
+        else {
+            /* RLGR decoding */
+            common::RLGRDecoder rlgr_dec;
+            rlgr_dec.Decode(temp_color, this->slice_.color_size, 3 * this->slice_.size);
+            auto rlgr_res       = rlgr_dec.GetResult();
+            /* Reconstruct coefficients */
+            for (int c = 0; c < 3; ++c) {
+                this->Dequantize(c, rlgr_res + c * this->slice_.size);
+            }
         }
         /* If intra slice, clear tree and related container */
         if (!common::CheckSliceType(this->slice_.type, common::PVVC_SLICE_TYPE_PREDICT)) {
@@ -233,9 +355,18 @@ namespace octree {
         
         /* coefficients_ and source_cloud_ have the same size */
         int coefficients_index = this->source_cloud_index_ - 1;
+        /* Integer RAHT runs on int_raht of each node, so decoded colors are bit-exact with encoder and CPU decoder */
+        const bool fixed = common::CheckSliceExt(this->slice_.type, this->slice_.ext, common::PVVC_SLICE_EXT_INT_RAHT);
 
         /* Set g_DC */
-        this->tree_[0].nodes[0].raht[0] = this->coefficients_[coefficients_index];
+        if (fixed) {
+            for (int c = 0; c < 3; ++c) {
+                this->tree_[0].nodes[0].int_raht[0][c] = this->int_coefficients_[3 * coefficients_index + c];
+            }
+        }
+        else {
+            this->tree_[0].nodes[0].raht[0] = this->coefficients_[coefficients_index];
+        }
         coefficients_index--;
 
         for (int i = 0; i < this->tree_height_ - 1; ++i) {
@@ -244,26 +375,52 @@ namespace octree {
                 /* Set h_ACs */
                 for (int idx = 1; idx < 8; ++idx) {
                     if (node.weight[NodeWeight[idx][0]] != 0 && node.weight[NodeWeight[idx][1]] != 0) {
-                        node.raht[idx] = this->coefficients_[coefficients_index];
+                        if (fixed) {
+                            for (int c = 0; c < 3; ++c) {
+                                node.int_raht[idx][c] = this->int_coefficients_[3 * coefficients_index + c];
+                            }
+                        }
+                        else {
+                            node.raht[idx] = this->coefficients_[coefficients_index];
+                        }
                         coefficients_index --;
                     }
                 }
                 /* Compute g_DC */
-                node.InvertHierarchicalTransform();
+                if (fixed) {
+                    node.IntInvertHierarchicalTransform();
+                }
+                else {
+                    node.InvertHierarchicalTransform();
+                }
 
                 /* Update g_DC for each subnode */
                 for (int idx = 0; idx < 8; ++idx) {
                     if (node.index[idx] != -1) {
-                        this->tree_[i + 1].nodes[node.index[idx]].raht[0] = node.raht[idx + 8];
+                        if (fixed) {
+                            for (int c = 0; c < 3; ++c) {
+                                this->tree_[i + 1].nodes[node.index[idx]].int_raht[0][c] = node.int_raht[idx + 8][c];
+                            }
+                        }
+                        else {
+                            this->tree_[i + 1].nodes[node.index[idx]].raht[0] = node.raht[idx + 8];
+                        }
                     }
                 }
             }
         }
 
-        /* Collect colors */
+        /* Collect colors, fixed-point to float is exact since scale is a power of two */
         OctreeLayer_t &last_layer = this->tree_[tree_height_ - 1];
+        const float scale = 1.0f / static_cast<float>(1 << common::INT_RAHT_FRAC_BITS);
         for (int i = 0; i < last_layer.length; i++){
-            this->source_colors_[i] = last_layer.nodes[i].raht[0];
+            if (fixed) {
+                const int32_t* g = last_layer.nodes[i].int_raht[0];
+                this->source_colors_[i] = common::ColorYUV(static_cast<float>(g[0]) * scale, static_cast<float>(g[1]) * scale, static_cast<float>(g[2]) * scale);
+            }
+            else {
+                this->source_colors_[i] = last_layer.nodes[i].raht[0];
+            }
         }
 
         if (common::CheckSliceType(this->slice_.type, common::PVVC_SLICE_TYPE_PREDICT)) {
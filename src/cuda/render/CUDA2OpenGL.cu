@@ -24,6 +24,7 @@ struct Points
  * @param {int} timestamp			帧序号
  * @param {int*} index				Patch 序号
  * @param {uint8_t*} type			Patch 的解码类型
+ * @param {uint8_t*} ext			Patch 的扩展类型
  * @param {float**} mv				每个 Patch 的 MotionVector
  * @param {uint32_t*} size			每个 Patch 解压后的 点数
  * @param {uint8_t*} qp				
@@ -34,11 +35,11 @@ struct Points
  * @param {InvertRAHTOctree*} invertRAHTOctree_gpu
  * @return {*}
  */
-__global__ void processCUDA(Points* cudaData, int timestamp, int* inner_offset, int* index, uint8_t* type, float** mv, uint32_t* size, uint8_t* qp, uint8_t** geometry, uint32_t* geometry_size, uint8_t** color, uint32_t* color_size, vvc::client::octree::InvertRAHTOctree* invertRAHTOctree_gpu, int patch_size)
+__global__ void processCUDA(Points* cudaData, int timestamp, int* inner_offset, int* index, uint8_t* type, uint8_t* ext, float** mv, uint32_t* size, uint8_t* qp, uint8_t** geometry, uint32_t* geometry_size, uint8_t** color, uint32_t* color_size, vvc::client::octree::InvertRAHTOctree* invertRAHTOctree_gpu, int patch_size)
 {
 	int idx = blockIdx.x * blockDim.x + threadIdx.x;
 	if (idx < patch_size){
-		vvc::client::common::Slice_t slice(timestamp, index[idx], type[idx], mv[idx], size[idx], qp[idx], geometry[idx], geometry_size[idx], color[idx], color_size[idx]);
+		vvc::client::common::Slice_t slice(timestamp, index[idx], type[idx], ext[idx], mv[idx], size[idx], qp[idx], geometry[idx], geometry_size[idx], color[idx], color_size[idx]);
 		invertRAHTOctree_gpu[index[idx]].SetSlice(slice);
 		// 找到帧内偏移
 		int offset = inner_offset[idx];
@@ -65,10 +66,10 @@ __global__ void processCUDA(Points* cudaData, int timestamp, int* inner_offset,
 	}
 }
 
-extern "C" void launch_cudaProcess(int grid, int block, Points * cudaData, int timestamp, int* inner_offset, int* index, uint8_t* type, float** mv, uint32_t* size, uint8_t* qp, uint8_t** geometry, uint32_t* geometry_size, uint8_t** color, uint32_t* color_size, vvc::client::octree::InvertRAHTOctree* invertRAHTOctree_gpu, int patch_size){
+extern "C" void launch_cudaProcess(int grid, int block, Points * cudaData, int timestamp, int* inner_offset, int* index, uint8_t* type, uint8_t* ext, float** mv, uint32_t* size, uint8_t* qp, uint8_t** geometry, uint32_t* geometry_size, uint8_t** color, uint32_t* color_size, vvc::client::octree::InvertRAHTOctree* invertRAHTOctree_gpu, int patch_size){
 	cudaStream_t stream1;
 	cudaError_t result;
 	result = cudaStreamCreate(&stream1);
-	processCUDA <<<grid, block,0 ,stream1>>> (cudaData, timestamp, inner_offset, index, type, mv, size, qp, geometry, geometry_size, color, color_size, invertRAHTOctree_gpu, patch_size);
+	processCUDA <<<grid, block,0 ,stream1>>> (cudaData, timestamp, inner_offset, index, type, ext, mv, size, qp, geometry, geometry_size, color, color_size, invertRAHTOctree_gpu, patch_size);
 	result = cudaStreamDestroy(stream1);
 }
@@ -276,6 +276,7 @@ namespace client {
                                CUDAFrame[index].inner_offset_gpu,
                                CUDAFrame[index].index_gpu,
                                CUDAFrame[index].type_gpu,
+                               CUDAFrame[index].ext_gpu,
                                CUDAFrame[index].mv_gpu,
                                CUDAFrame[index].size_gpu,
                                CUDAFrame[index].qp_gpu,
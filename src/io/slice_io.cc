@@ -46,6 +46,14 @@ namespace io {
 			}
 			stream_size += sizeof(uint8_t) * 1;
 
+			/* Extension byte follows type */
+			if (common::CheckSliceType(_slice.type, common::PVVC_SLICE_TYPE_EXTEND)) {
+				if (fwrite(&_slice.ext, sizeof(uint8_t), 1, fp) != 1) {
+					throw __EXCEPT__(FILE_WRITE_ERROR);
+				}
+				stream_size += sizeof(uint8_t) * 1;
+			}
+
 			if (fwrite(&_slice.timestamp, sizeof(int), 1, fp) != 1) {
 				throw __EXCEPT__(FILE_WRITE_ERROR);
 			}
@@ -66,6 +74,13 @@ namespace io {
 			}
 			stream_size += sizeof(uint8_t) * 1;
 
+			if (common::CheckSliceExt(_slice.type, _slice.ext, common::PVVC_SLICE_EXT_LEVEL_QUANT)) {
+				if (fwrite(&_slice.level_step, sizeof(uint8_t), 1, fp) != 1) {
+					throw __EXCEPT__(FILE_WRITE_ERROR);
+				}
+				stream_size += sizeof(uint8_t) * 1;
+			}
+
 			if (fwrite(&_slice.mv, sizeof(Eigen::Matrix4f), 1, fp) != 1) {
 				throw __EXCEPT__(FILE_WRITE_ERROR);
 			}
@@ -117,6 +132,28 @@ namespace io {
 		}
 	}
 
+	size_t SliceHeaderSize(const common::Slice& _slice) {
+		/* Same fields in same order as SaveSlice */
+		size_t size = sizeof(_slice.type);
+		if (common::CheckSliceType(_slice.type, common::PVVC_SLICE_TYPE_EXTEND)) {
+			size += sizeof(_slice.ext);
+		}
+		size += sizeof(_slice.timestamp) + sizeof(_slice.index) + sizeof(_slice.size) + sizeof(_slice.qp);
+		if (common::CheckSliceExt(_slice.type, _slice.ext, common::PVVC_SLICE_EXT_LEVEL_QUANT)) {
+			size += sizeof(_slice.level_step);
+		}
+		size += sizeof(_slice.mv);
+		/* Geometry size */
+		if (!common::CheckSliceType(_slice.type, common::PVVC_SLICE_TYPE_PREDICT)) {
+			size += sizeof(size_t);
+		}
+		/* Color size */
+		if (!common::CheckSliceType(_slice.type, common::PVVC_SLICE_TYPE_SKIP)) {
+			size += sizeof(size_t);
+		}
+		return size;
+	}
+
 	void LoadSlice(common::Slice& _slice, const std::string& _name) {
 		try {
 			std::regex name_type{"^.*\\.slice"};
@@ -144,6 +181,12 @@ namespace io {
 				throw __EXCEPT__(BAD_SLICE);
 			}
 
+			if (common::CheckSliceType(_slice.type, common::PVVC_SLICE_TYPE_EXTEND)) {
+				if (fread(&_slice.ext, sizeof(uint8_t), 1, fp) != 1) {
+					throw __EXCEPT__(FILE_READ_ERROR);
+				}
+			}
+
 			if (fread(&_slice.timestamp, sizeof(int), 1, fp) != 1) {
 				throw __EXCEPT__(FILE_READ_ERROR);
 			}
@@ -160,6 +203,12 @@ namespace io {
 				throw __EXCEPT__(FILE_READ_ERROR);
 			}
 
+			if (common::CheckSliceExt(_slice.type, _slice.ext, common::PVVC_SLICE_EXT_LEVEL_QUANT)) {
+				if (fread(&_slice.level_step, sizeof(uint8_t), 1, fp) != 1) {
+					throw __EXCEPT__(FILE_READ_ERROR);
+				}
+			}
+
 			if (fread(&_slice.mv, sizeof(Eigen::Matrix4f), 1, fp) != 1) {
 				throw __EXCEPT__(FILE_READ_ERROR);
 			}
@@ -271,6 +320,13 @@ namespace io {
 				throw __EXCEPT__(FILE_WRITE_ERROR);
 			}
 
+			/* Extension bytes follow types if any slice is extended */
+			if (std::any_of(frame.type.begin(), frame.type.end(), [](uint8_t t) { return common::CheckSliceType(t, common::PVVC_SLICE_TYPE_EXTEND); })) {
+				if (fwrite(frame.ext.data(), sizeof(uint8_t), frame.slice_cnt, fp) != frame.slice_cnt) {
+					throw __EXCEPT__(FILE_WRITE_ERROR);
+				}
+			}
+
 			if (fwrite(frame.size.data(), sizeof(uint32_t), frame.slice_cnt, fp) != frame.slice_cnt) {
 				throw __EXCEPT__(FILE_WRITE_ERROR);
 			}
@@ -279,6 +335,17 @@ namespace io {
 				throw __EXCEPT__(FILE_WRITE_ERROR);
 			}
 
+			/* Level steps follow QPs if any slice is quantized by level */
+			bool level_quant = false;
+			for (uint32_t i = 0; i < frame.slice_cnt; ++i) {
+				level_quant |= common::CheckSliceExt(frame.type[i], frame.ext[i], common::PVVC_SLICE_EXT_LEVEL_QUANT);
+			}
+			if (level_quant) {
+				if (fwrite(frame.level_step.data(), sizeof(uint8_t), frame.slice_cnt, fp) != frame.slice_cnt) {
+					throw __EXCEPT__(FILE_WRITE_ERROR);
+				}
+			}
+
 			for (auto& i : frame.mv) {
 				for (int row = 0; row < 4; row++) {
 					for (int col = 0; col < 4; col++) {
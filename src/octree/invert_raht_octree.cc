@@ -17,7 +17,10 @@
 namespace vvc {
 namespace octree {
 
-	InvertRAHTOctree::InvertRAHTOctree() : tree_{}, source_cloud_{nullptr}, source_colors_{nullptr}, slice_{} {}
+	/* Min coefficient number of a split color slice to decode its channels in parallel */
+	static int PARALLEL_CHANNEL_THS = 1 << 15;
+
+	InvertRAHTOctree::InvertRAHTOctree() : tree_{}, plan_{}, lod_depth_{0}, lod_scales_{}, source_cloud_{nullptr}, source_colors_{nullptr}, slice_{} {}
 
 	void InvertRAHTOctree::SetSlice(const common::Slice& _slice) {
 		try {
@@ -26,8 +29,13 @@ namespace octree {
 				throw __EXCEPT__(BAD_SLICE);
 			}
 
-			/* _slice should have data */
-			if (!_slice.geometry && !_slice.color) {
+			/* _slice should have data, except skip slice which is a predictive header only */
+			if (common::CheckSliceType(_slice.type, common::PVVC_SLICE_TYPE_SKIP)) {
+				if (!common::CheckSliceType(_slice.type, common::PVVC_SLICE_TYPE_PREDICT)) {
+					throw __EXCEPT__(BAD_SLICE);
+				}
+			}
+			else if (!_slice.geometry && !_slice.color) {
 				throw __EXCEPT__(BAD_SLICE);
 			}
 
@@ -49,6 +57,38 @@ namespace octree {
 				this->node_values_ = this->slice_.geometry;
 			}
 
+			/* If intra slice, clear tree and related container, octree is built first since arithmetic coded colors need its contexts */
+			if (!common::CheckSliceType(this->slice_.type, common::PVVC_SLICE_TYPE_PREDICT)) {
+				this->tree_.clear();
+				this->source_cloud_.reset(new pcl::PointCloud<pcl::PointXYZ>());
+				this->reference_colors_ = std::make_shared<std::vector<common::ColorYUV>>();
+				this->source_colors_    = std::make_shared<std::vector<common::ColorYUV>>();
+				this->MakeTree();
+			}
+			else if (this->slice_.size != this->tree_.back().size()) {
+				/* Predictive slice reuses octree and plan of intra slice */
+				throw __EXCEPT__(UNMATCHED_COLOR_SIZE);
+			}
+
+			/* Positions are ready, color payload is skipped */
+			if (this->params_->decode.geometry_only) {
+				return;
+			}
+
+			/* Residual of skip slice is zero, colors are the reference ones, no decoding and invert RAHT */
+			if (common::CheckSliceType(this->slice_.type, common::PVVC_SLICE_TYPE_SKIP)) {
+				if (this->reference_colors_->size() != this->plan_.size()) {
+					throw __EXCEPT__(EMPTY_REFERENCE);
+				}
+				this->source_colors_->assign(this->reference_colors_->begin(), this->reference_colors_->end());
+				return;
+			}
+
+			bool arith = common::CheckSliceType(this->slice_.type, common::PVVC_SLICE_TYPE_COLOR_ARITH);
+			if (arith && this->contexts_.size() != this->slice_.size) {
+				throw __EXCEPT__(UNMATCHED_COLOR_SIZE);
+			}
+
 			auto temp_color = this->slice_.color;
 			if (common::CheckSliceType(this->slice_.type, common::PVVC_SLICE_TYPE_COLOR_ZSTD)) {
 				common::ZstdDecoder dec;
@@ -56,26 +96,82 @@ namespace octree {
 				temp_color = dec.GetResult();
 			}
 
-			/* RLGR decoding */
-			common::RLGRDecoder rlgr_dec;
-			rlgr_dec.Decode(temp_color, 3 * this->slice_.size);
-			auto rlgr_res       = rlgr_dec.GetResult();
-			this->coefficients_ = std::make_shared<std::vector<common::ColorYUV>>(this->slice_.size);
-			/* Reconstruct coefficients */
-			for (int i = 0; i < this->slice_.size; ++i) {
-				this->coefficients_->at(i).y = static_cast<float>(rlgr_res->at(i) * this->slice_.qp);
-				this->coefficients_->at(i).u = static_cast<float>(rlgr_res->at(i + this->slice_.size) * this->slice_.qp);
-				this->coefficients_->at(i).v = static_cast<float>(rlgr_res->at(i + 2 * this->slice_.size) * this->slice_.qp);
+			/* RLGR or arithmetic decoding, only the last count coefficients of each plane are needed to reconstruct level lod_depth_ */
+			const size_t count = this->plan_.size();
+			if (common::CheckSliceExt(this->slice_.type, this->slice_.ext, common::PVVC_SLICE_EXT_LEVEL_COLOR)) {
+				/* Size table of level substreams, levels deeper than lod_depth_ are not decoded */
+				const size_t table = this->tree_.size() * common::PVVC_SLICE_COLOR_LEVEL_ENTRY;
+				if (temp_color->size() < table) {
+					throw __EXCEPT__(BAD_SLICE);
+				}
+				const uint8_t* data  = temp_color->data() + table;
+				size_t         left  = temp_color->size() - table;
+				size_t         upper = 0;
+				this->symbols_.resize(3 * count);
+				for (int d = 0; d <= this->lod_depth_; ++d) {
+					size_t length = 0;
+					for (int b = 0; b < common::PVVC_SLICE_COLOR_LEVEL_ENTRY; ++b) {
+						length = (length << 8) | temp_color->at(d * common::PVVC_SLICE_COLOR_LEVEL_ENTRY + b);
+					}
+					if (length > left) {
+						throw __EXCEPT__(BAD_SLICE);
+					}
+					/* Level d holds [size - n_d, size - n_{d-1}) in coding order */
+					const size_t nodes = this->tree_[d].size();
+					this->DecodePlanes(data, length, this->contexts_.data() + this->slice_.size - nodes, count - nodes, nodes - upper, count);
+					data += length, left -= length;
+					upper = nodes;
+				}
+			}
+			else {
+				this->symbols_.resize(3 * this->slice_.size);
+				this->DecodePlanes(temp_color->data(), temp_color->size(), this->contexts_.data(), 0, this->slice_.size, this->slice_.size);
+				if (count != this->slice_.size) {
+					for (int c = 0; c < 3; ++c) {
+						auto plane = this->symbols_.begin() + c * this->slice_.size + (this->slice_.size - count);
+						std::copy(plane, plane + count, this->symbols_.begin() + c * count);
+					}
+					this->symbols_.resize(3 * count);
+				}
 			}
 
-			/* If intra slice, clear tree and related container */
-			if (!common::CheckSliceType(this->slice_.type, common::PVVC_SLICE_TYPE_PREDICT)) {
-				this->tree_.clear();
-				this->source_cloud_.reset(new pcl::PointCloud<pcl::PointXYZ>());
-				this->reference_colors_ = std::make_shared<std::vector<common::ColorYUV>>();
-				this->source_colors_    = std::make_shared<std::vector<common::ColorYUV>>();
-				this->MakeTree();
+			/* Reconstruct coefficients, symbols and coefficients are both Y/U/V planes */
+			const bool fixed = common::CheckSliceExt(this->slice_.type, this->slice_.ext, common::PVVC_SLICE_EXT_INT_RAHT);
+			if (fixed) {
+				if (this->slice_.size > INT_RAHT_MAX_LEAVES) {
+					throw __EXCEPT__(BAD_SLICE);
+				}
+				this->int_coefficients_.resize(3 * count);
+			}
+			else {
+				this->coefficients_.resize(3 * count);
+			}
+			if (common::CheckSliceExt(this->slice_.type, this->slice_.ext, common::PVVC_SLICE_EXT_LEVEL_QUANT)) {
+				/* Level d holds [count - n_d, count - n_{d-1}) of each plane, dequantized by its own step */
+				size_t upper = 0;
+				for (int d = 0; d <= this->lod_depth_; ++d) {
+					const size_t nodes = this->tree_[d].size(), first = count - nodes;
+					const float  step  = common::LevelStep(this->slice_.qp, this->slice_.level_step, this->tree_height_, d);
+					for (int c = 0; c < 3; ++c) {
+						const size_t offset = c * count + first;
+						if (fixed) {
+							const int64_t step_fixed = common::LevelStepFixed(static_cast<int64_t>(this->slice_.qp) << INT_RAHT_FRAC_BITS, this->slice_.level_step, this->tree_height_, d);
+							common::DequantizeFixed(this->symbols_.data() + offset, this->int_coefficients_.data() + offset, nodes - upper, step_fixed);
+						}
+						else {
+							common::DequantizeStep(this->symbols_.data() + offset, this->coefficients_.data() + offset, nodes - upper, step);
+						}
+					}
+					upper = nodes;
+				}
+			}
+			else if (fixed) {
+				common::DequantizeFixed(this->symbols_.data(), this->int_coefficients_.data(), 3 * count, static_cast<int64_t>(this->slice_.qp) << INT_RAHT_FRAC_BITS);
 			}
+			else {
+				common::DequantizeYUV(this->symbols_.data(), this->coefficients_.data(), count, this->slice_.qp);
+			}
+
 			this->InvertRAHT();
 		}
 		catch (const common::Exception& e) {
@@ -84,17 +180,88 @@ namespace octree {
 		}
 	}
 
+	void InvertRAHTOctree::DecodePlanes(const uint8_t* _data, size_t _length, const uint8_t* _context, size_t _offset, size_t _size, size_t _stride) {
+		common::FIX_DATA_INT* result = this->symbols_.data() + _offset;
+		if (common::CheckSliceType(this->slice_.type, common::PVVC_SLICE_TYPE_COLOR_SPLIT)) {
+			/* Size table of Y and U substreams, V takes the rest */
+			if (_length < common::PVVC_SLICE_COLOR_SPLIT_TABLE) {
+				throw __EXCEPT__(BAD_SLICE);
+			}
+			size_t length[3]{};
+			for (int c = 0; c < 2; ++c) {
+				for (int i = 0; i < 4; ++i) {
+					length[c] = (length[c] << 8) | _data[c * 4 + i];
+				}
+			}
+			if (common::PVVC_SLICE_COLOR_SPLIT_TABLE + length[0] + length[1] > _length) {
+				throw __EXCEPT__(BAD_SLICE);
+			}
+			length[2] = _length - common::PVVC_SLICE_COLOR_SPLIT_TABLE - length[0] - length[1];
+
+			const uint8_t* start[3]{};
+			start[0] = _data + common::PVVC_SLICE_COLOR_SPLIT_TABLE;
+			start[1] = start[0] + length[0];
+			start[2] = start[1] + length[1];
+
+			/* Substreams are independent, decode Y, U and V concurrently on the shared pool for large slices */
+			if (_size >= PARALLEL_CHANNEL_THS && this->params_ && this->params_->thread_num > 1) {
+				common::WorkerPool::Global(this->params_->thread_num).ParallelFor(3, [&](size_t c) { this->DecodeChannel(start[c], length[c], _context, result + c * _stride, _size); });
+			}
+			else {
+				for (int c = 0; c < 3; ++c) {
+					this->DecodeChannel(start[c], length[c], _context, result + c * _stride, _size);
+				}
+			}
+		}
+		else {
+			/* Planes are contiguous in stream, decoded in place if they are also contiguous in symbols_ */
+			common::FIX_DATA_INT* planes = result;
+			if (_stride != _size) {
+				this->level_symbols_.resize(3 * _size);
+				planes = this->level_symbols_.data();
+			}
+			if (common::CheckSliceType(this->slice_.type, common::PVVC_SLICE_TYPE_COLOR_ARITH)) {
+				common::CoefficientDecoder dec;
+				dec.Decode(_data, _length, _context, planes, _size, 3);
+			}
+			else {
+				common::RLGRDecoder dec;
+				dec.Decode(_data, _length, planes, 3 * _size);
+			}
+			if (planes != result) {
+				for (int c = 0; c < 3; ++c) {
+					std::copy(planes + c * _size, planes + (c + 1) * _size, result + c * _stride);
+				}
+			}
+		}
+	}
+
+	void InvertRAHTOctree::DecodeChannel(const uint8_t* _data, size_t _length, const uint8_t* _context, common::FIX_DATA_INT* _result, size_t _size) {
+		if (common::CheckSliceType(this->slice_.type, common::PVVC_SLICE_TYPE_COLOR_ARITH)) {
+			common::CoefficientDecoder dec;
+			dec.Decode(_data, _length, _context, _result, _size, 1);
+		}
+		else {
+			common::RLGRDecoder dec;
+			dec.Decode(_data, _length, _result, _size);
+		}
+	}
+
 	common::Patch InvertRAHTOctree::GetPatch() const {
 		try {
 			if (!this->source_cloud_ || this->source_cloud_->empty()) {
 				throw __EXCEPT__(EMPTY_RESULT);
 			}
-			if (!this->source_colors_ || this->source_colors_->empty()) {
-				throw __EXCEPT__(EMPTY_RESULT);
-			}
+			/* Points of geometry only decoding keep default black color */
+			bool colored = !this->params_ || !this->params_->decode.geometry_only;
+			if (colored) {
+				if (!this->source_colors_ || this->source_colors_->empty()) {
+					throw __EXCEPT__(EMPTY_RESULT);
+				}
 
-			if (this->source_colors_->size() != this->source_cloud_->size()) {
-				throw __EXCEPT__(UNMATCHED_COLOR_SIZE);
+				if (this->source_colors_->size() != this->source_cloud_->size()) {
+					throw __EXCEPT__(UNMATCHED_COLOR_SIZE);
+				}
 			}
 			/* Generate Patch and copy data */
 			vvc::common::Patch result;
@@ -104,11 +271,14 @@ namespace octree {
 
 			/* Malloc a point cloud */
 			result.cloud.reset(new pcl::PointCloud<pcl::PointXYZRGB>());
-			/* Convert yuv to rgb and concate with xyz */
-			for (int i = 0; i < this->source_cloud_->size(); ++i) {
+			result.cloud->reserve(this->source_cloud_->size());
+			/* Convert yuv to rgb and concate with xyz, sizes are checked above */
+			for (size_t i = 0; i < this->source_cloud_->size(); ++i) {
 				pcl::PointXYZRGB p;
-				p.x = this->source_cloud_->at(i).x, p.y = this->source_cloud_->at(i).y, p.z = this->source_cloud_->at(i).z;
-				this->source_colors_->at(i).ConvertRGB(p);
+				p.x = (*this->source_cloud_)[i].x, p.y = (*this->source_cloud_)[i].y, p.z = (*this->source_cloud_)[i].z;
+				if (colored) {
+					(*this->source_colors_)[i].ConvertRGB(p);
+				}
 				result.cloud->emplace_back(p);
 			}
 			return result;
@@ -155,31 +325,32 @@ namespace octree {
 
 			LoadTreeCore(this->tree_center_, this->tree_range_, this->tree_height_, tree_attr);
 
-			this->tree_.resize(this->tree_height_);
+			/* Arithmetic coded occupancy, decode it into raw bytes behind tree core */
+			if (common::CheckSliceExt(this->slice_.type, this->slice_.ext, common::PVVC_SLICE_EXT_GEO_ARITH)) {
+				auto                     raw = std::make_shared<std::vector<uint8_t>>(this->node_values_->begin(), iter);
+				common::OccupancyDecoder dec;
+				dec.Decode(this->node_values_->data() + raw->size(), this->node_values_->size() - raw->size(), this->tree_height_ - 1, this->slice_.size, *raw);
+				this->node_values_ = raw;
+				iter               = std::next(this->node_values_->begin(), sizeof(tree_attr));
+			}
+
+			this->tree_.assign(this->tree_height_, OctreeLayer_t());
 			int curr_layer_node_count = 1;
 
 			/* Assign value for each branch node */
 			for (int idx = 0; idx < this->tree_height_ - 1; ++idx) {
 				/* Count how many nodes next layer has */
-				int next_layer_node_count = 0;
+				int   next_layer_node_count = 0;
+				auto& layer                 = this->tree_.at(idx);
 				/* Assign nodes in current layer */
-				this->tree_.at(idx).resize(curr_layer_node_count);
+				layer.assign(curr_layer_node_count, false);
 				for (int cnt = 0; cnt < curr_layer_node_count; ++cnt) {
 					if (iter != this->node_values_->end()) {
-						/* Set value */
-						this->tree_.at(idx).at(cnt).value = *iter;
+						/* Set value, children are contiguous in next layer */
+						layer.value[cnt] = *iter;
+						layer.child[cnt] = next_layer_node_count;
 						/* Count 1-bits of this node */
-						for (auto i : NodeValue) {
-							/* 0-bit, index is -1 */
-							if (((*iter) & i) == 0) {
-								this->tree_.at(idx).at(cnt).index.emplace_back(-1);
-							}
-							/* 1-bit */
-							else {
-								this->tree_.at(idx).at(cnt).index.emplace_back(next_layer_node_count);
-								++next_layer_node_count;
-							}
-						}
+						next_layer_node_count += __builtin_popcount(*iter);
 						iter = std::next(iter, 1);
 					}
 				}
@@ -189,10 +360,36 @@ namespace octree {
 				throw __EXCEPT__(UNMATCHED_COLOR_SIZE);
 			}
 			/* Malloc space for last layer */
-			this->tree_.back().resize(curr_layer_node_count);
+			this->tree_.back().assign(curr_layer_node_count, true);
+
+			/* Depth of decoded level, predictive slices keep the one of their intra slice */
+			this->lod_depth_ = this->tree_height_ - 1;
+			if (this->params_->decode.lod > 0) {
+				this->lod_depth_ = std::min(this->params_->decode.lod, this->lod_depth_);
+			}
 
 			/* Update weight and add point into cloud */
-			this->AddPoints(0, 0, this->tree_center_, this->tree_range_);
+			this->AddPoints();
+
+			/* Coefficient contexts and invert transform plan only depend on geometry */
+			if (!this->params_->decode.geometry_only) {
+				RAHTContext(this->tree_, this->contexts_);
+				this->lod_scales_.clear();
+				if (this->lod_depth_ == this->tree_height_ - 1) {
+					this->plan_.Build(this->tree_);
+				}
+				else {
+					/* Nodes of lod_depth_ are leaves of the truncated tree, their low-pass coefficients are √weight times mean colors */
+					std::vector<OctreeLayer_t> levels(this->tree_.begin(), this->tree_.begin() + this->lod_depth_ + 1);
+					this->plan_.Build(levels);
+					const auto& weight = this->tree_[this->lod_depth_].weight;
+					this->lod_scales_.resize(weight.size());
+					for (size_t n = 0; n < weight.size(); ++n) {
+						this->lod_scales_[n] = 1.0f / std::sqrt(static_cast<float>(weight[n]));
+					}
+				}
+				this->plan_.SetPool(RAHTPool(this->params_, this->plan_.size()));
+			}
 		}
 		catch (const common::Exception& e) {
 			e.Log();
@@ -200,56 +397,37 @@ namespace octree {
 		}
 	}
 
-	void InvertRAHTOctree::AddPoints(const int _height, const int _index, const pcl::PointXYZ _center, const pcl::PointXYZ _range) {
-		try {
-			/* Check valid */
-			if (_height >= this->tree_height_) {
-				throw __EXCEPT__(OUT_OF_RANGE);
-			}
-			if (_index >= this->tree_.at(_height).size()) {
-				throw __EXCEPT__(OUT_OF_RANGE);
-			}
-
-			auto& node = this->tree_[_height][_index];
-			/* Leaf layer */
-			if (_height == this->tree_height_ - 1) {
-				node.value     = 0xff;
-				node.weight[1] = 1;
-				this->source_cloud_->emplace_back(_center);
-				node.index.emplace_back(this->source_cloud_->size());
-			}
-			else {
-				/* Subrange : half of _range */
-				pcl::PointXYZ subrange(_range.x / 2.0f, _range.y / 2.0f, _range.z / 2.0f);
-
-				/* For each subnode */
-				for (int i = 0; i < 8; ++i) {
-					/* If subnode is not empty */
-					if (node.index[i] != -1) {
-						/* Compute subnode center */
-						pcl::PointXYZ subcenter = SubSpaceCenter(_center, subrange, i);
-						/* Iteratively traversal */
-						this->AddPoints(_height + 1, node.index[i], subcenter, subrange);
-					}
-				}
-
-				/* Update weight
-				 * Note the weights of children of node are already computed
-				 * */
+	void InvertRAHTOctree::AddPoints() {
+		/* Centers of nodes in current layer, children are contiguous in next layer so level order is also the depth-first order */
+		std::vector<pcl::PointXYZ> curr(1, this->tree_center_), next;
+		pcl::PointXYZ              range = this->tree_range_;
+		for (int h = 0; h < this->lod_depth_; ++h) {
+			const auto& layer = this->tree_[h];
+			/* Subrange : half of range */
+			pcl::PointXYZ subrange(range.x / 2.0f, range.y / 2.0f, range.z / 2.0f);
+			next.resize(this->tree_[h + 1].size());
+			for (size_t n = 0; n < layer.size(); ++n) {
+				int child = layer.child[n];
 				for (int i = 0; i < 8; ++i) {
-					if (node.index[i] != -1) {
-						node.weight[i + 8] = this->tree_[_height + 1][node.index[i]].weight[1];
+					if (layer.value[n] & NodeValue[i]) {
+						next[child++] = SubSpaceCenter(curr[n], subrange, i);
 					}
 				}
-
-				for (int i = 7; i > 0; --i) {
-					node.weight[i] = node.weight[NodeWeight[i][0]] + node.weight[NodeWeight[i][1]];
-				}
 			}
+			curr.swap(next);
+			range = subrange;
 		}
-		catch (const common::Exception& e) {
-			e.Log();
-			throw __EXCEPT__(ERROR_OCCURED);
+		this->source_cloud_->resize(curr.size());
+		std::copy(curr.begin(), curr.end(), this->source_cloud_->begin());
+
+		/* Update weight from leaves to root, weights of leaves are already 1 */
+		for (int h = this->tree_height_ - 2; h >= 0; --h) {
+			auto&       layer = this->tree_[h];
+			const auto& lower = this->tree_[h + 1].weight;
+			for (size_t n = 0; n < layer.size(); ++n) {
+				auto first      = lower.begin() + layer.child[n];
+				layer.weight[n] = std::accumulate(first, first + __builtin_popcount(layer.value[n]), 0);
+			}
 		}
 	}
 
@@ -261,52 +439,41 @@ namespace octree {
 			if (this->tree_.size() != this->tree_height_ || this->tree_height_ <= 0) {
 				throw __EXCEPT__(EMPTY_OCTREE);
 			}
-			if (!this->coefficients_ || this->coefficients_->size() != this->source_cloud_->size()) {
+			bool fixed = common::CheckSliceExt(this->slice_.type, this->slice_.ext, common::PVVC_SLICE_EXT_INT_RAHT);
+			if ((fixed ? this->int_coefficients_.size() : this->coefficients_.size()) != 3 * this->source_cloud_->size()) {
 				throw __EXCEPT__(UNMATCHED_COLOR_SIZE);
 			}
-			std::reverse(this->coefficients_->begin(), this->coefficients_->end());
-			/* Iterator */
-			auto iter = this->coefficients_->begin();
-
-			/* Set g_DC */
-			this->tree_.front().front().raht[0] = *iter;
-
-			// iter = std::next(iter, 1);
-			++iter;
-
-			for (int i = 0; i < this->tree_height_ - 1; ++i) {
-				for (auto& node : this->tree_[i]) {
-					/* Set h_ACs */
-					for (int idx = 1; idx < 8; ++idx) {
-						if (node.weight[NodeWeight[idx][0]] != 0 && node.weight[NodeWeight[idx][1]] != 0) {
-							node.raht[idx] = *iter;
-							// iter           = std::next(iter, 1);
-							++iter;
-						}
-					}
-					/* Compute g_DC */
-					node.InvertHierarchicalTransform();
-
-					/* Update g_DC for each subnode */
-					for (int idx = 0; idx < 8; ++idx) {
-						if (node.index[idx] != -1) {
-							this->tree_[i + 1][node.index[idx]].raht[0] = node.raht[idx + 8];
-						}
-					}
-				}
+			if (this->plan_.size() != this->source_cloud_->size()) {
+				throw __EXCEPT__(UNMATCHED_COLOR_SIZE);
 			}
 
-			/* Collect colors */
-			this->source_colors_->clear();
-			for (auto& node : this->tree_.back()) {
-				this->source_colors_->emplace_back(node.raht[0]);
-			}
+			/* Invert transform by plan cached at intra slice, colors of leaves are in the same order as source_cloud_ */
+			const common::ColorYUV* reference = nullptr;
 			if (common::CheckSliceType(this->slice_.type, common::PVVC_SLICE_TYPE_PREDICT)) {
-				for (int i = 0; i < this->source_colors_->size(); ++i) {
-					this->source_colors_->at(i) += this->reference_colors_->at(i);
+				if (this->reference_colors_->size() != this->plan_.size()) {
+					throw __EXCEPT__(EMPTY_REFERENCE);
 				}
+				/* Invert compensation is done while leaves are written out */
+				reference = this->reference_colors_->data();
+			}
+			this->source_colors_->resize(this->plan_.size());
+			/* Leaves of a truncated tree are scaled to mean colors before compensation */
+			const common::ColorYUV* fused = this->lod_scales_.empty() ? reference : nullptr;
+			if (fixed) {
+				this->plan_.IntInvertTransform(this->int_coefficients_.data(), this->source_colors_->data(), fused);
 			}
 			else {
+				this->plan_.InvertTransform(this->coefficients_.data(), this->source_colors_->data(), fused);
+			}
+			if (!this->lod_scales_.empty()) {
+				for (size_t i = 0; i < this->source_colors_->size(); ++i) {
+					(*this->source_colors_)[i] *= this->lod_scales_[i];
+					if (reference) {
+						(*this->source_colors_)[i] += reference[i];
+					}
+				}
+			}
+			if (!reference) {
 				this->reference_colors_->assign(this->source_colors_->begin(), this->source_colors_->end());
 			}
 		}
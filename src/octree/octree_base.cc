@@ -47,6 +47,41 @@ namespace octree {
 		_height = _p[24];
 	}
 
+	void ExpandWeight(const std::vector<OctreeLayer_t>& _tree, int _height, int _index, int (&_weight)[16]) {
+		const auto& layer = _tree[_height];
+		const auto& lower = _tree[_height + 1].weight;
+		int         child = layer.child[_index];
+		_weight[0]        = 0;
+		for (int i = 0; i < 8; ++i) {
+			_weight[i + 8] = (layer.value[_index] & NodeValue[i]) ? lower[child++] : 0;
+		}
+		for (int i = 7; i > 0; --i) {
+			_weight[i] = _weight[NodeWeight[i][0]] + _weight[NodeWeight[i][1]];
+		}
+	}
+
+	void RAHTContext(const std::vector<OctreeLayer_t>& _tree, std::vector<uint8_t>& _context) {
+		int height = _tree.size();
+		_context.clear();
+		/* g_DC, the highest level and weight */
+		_context.emplace_back(RAHT_CONTEXT_LEVEL * RAHT_CONTEXT_WEIGHT - 1);
+		/* h_AC, same order as RAHTOctree::RAHT */
+		int weight[16];
+		for (int i = 0; i < height - 1; ++i) {
+			int level = std::min(height - 2 - i, RAHT_CONTEXT_LEVEL - 1);
+			for (int node = 0; node < _tree[i].size(); ++node) {
+				ExpandWeight(_tree, i, node, weight);
+				for (int idx = 1; idx < 8; ++idx) {
+					if (weight[NodeWeight[idx][0]] != 0 && weight[NodeWeight[idx][1]] != 0) {
+						int w = std::min(31 - __builtin_clz(weight[idx]), RAHT_CONTEXT_WEIGHT - 1);
+						_context.emplace_back(level * RAHT_CONTEXT_WEIGHT + w);
+					}
+				}
+			}
+		}
+		std::reverse(_context.begin(), _context.end());
+	}
+
 	OctreeBase::OctreeBase() : tree_range_{0.0f, 0.0f, 0.0f}, tree_height_{0}, params_{nullptr}, tree_center_{} {}
 
 	void OctreeBase::SetParams(common::PVVCParam_t::Ptr _param) {
@@ -62,40 +97,40 @@ namespace octree {
 		}
 	}
 
-	void OctreeNode_t::HierarchicalTransform() {
+	void HierarchicalTransform(const int (&_weight)[16], common::ColorYUV (&_raht)[16]) {
 		common::ColorYUV H[8];
 		/* X/Y/Z merge */
 		for (int i = 7; i > 0; --i) {
-			std::pair<common::ColorYUV, common::ColorYUV> g(this->raht[NodeWeight[i][0]], this->raht[NodeWeight[i][1]]), res;
-			std::pair<int, int>                           w(this->weight[NodeWeight[i][0]], this->weight[NodeWeight[i][1]]);
+			std::pair<common::ColorYUV, common::ColorYUV> g(_raht[NodeWeight[i][0]], _raht[NodeWeight[i][1]]), res;
+			std::pair<int, int>                           w(_weight[NodeWeight[i][0]], _weight[NodeWeight[i][1]]);
 			/* Haar wavelet transform */
 			res = HaarTransform(w, g);
 			/* Record g and h */
-			this->raht[i] = res.first;
-			H[i]          = res.second;
+			_raht[i] = res.first;
+			H[i]     = res.second;
 		}
 		/* Save last g and all h */
-		this->raht[0] = this->raht[1];
+		_raht[0] = _raht[1];
 		for (int i = 1; i <= 7; ++i) {
-			this->raht[i] = H[i];
+			_raht[i] = H[i];
 		}
 	}
 
-	void OctreeNode_t::InvertHierarchicalTransform() {
+	void InvertHierarchicalTransform(const int (&_weight)[16], common::ColorYUV (&_raht)[16]) {
 		common::ColorYUV H[8];
 		for (int i = 0; i < 8; ++i) {
-			H[i] = this->raht[i];
+			H[i] = _raht[i];
 		}
 		/* g_DC */
-		this->raht[1] = H[0];
+		_raht[1] = H[0];
 		/* Invert X/Y/Z merge */
 		for (int i = 1; i < 8; ++i) {
-			std::pair<common::ColorYUV, common::ColorYUV> g(this->raht[i], H[i]), res;
-			std::pair<int, int>                           w(this->weight[NodeWeight[i][0]], this->weight[NodeWeight[i][1]]);
+			std::pair<common::ColorYUV, common::ColorYUV> g(_raht[i], H[i]), res;
+			std::pair<int, int>                           w(_weight[NodeWeight[i][0]], _weight[NodeWeight[i][1]]);
 			/* Inver haar wavelet transform */
-			res                          = InvertHaarTransform(w, g);
-			this->raht[NodeWeight[i][0]] = res.first;
-			this->raht[NodeWeight[i][1]] = res.second;
+			res                     = InvertHaarTransform(w, g);
+			_raht[NodeWeight[i][0]] = res.first;
+			_raht[NodeWeight[i][1]] = res.second;
 		}
 	}
 
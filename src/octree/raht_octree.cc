@@ -16,7 +16,7 @@
 
 namespace vvc {
 namespace octree {
-	RAHTOctree::RAHTOctree() : OctreeBase{}, tree_{}, source_cloud_{nullptr}, source_colors_{nullptr}, RAHT_result_{nullptr} {}
+	RAHTOctree::RAHTOctree() : OctreeBase{}, tree_{}, leaf_points_{}, leaf_offset_{}, leaf_colors_{}, plan_{}, source_cloud_{nullptr}, source_colors_{nullptr}, RAHT_result_{nullptr}, contexts_{} {}
 
 	void RAHTOctree::SetSourceCloud(pcl::PointCloud<pcl::PointXYZRGB>::Ptr _cloud) {
 		try {
@@ -48,10 +48,22 @@ namespace octree {
 		auto result = std::make_shared<std::vector<uint8_t>>();
 		SaveTreeCore(this->tree_center_, this->tree_range_, this->tree_height_, result);
 		for (int i = 0; i < this->tree_height_ - 1; ++i) {
-			for (auto& j : this->tree_.at(i)) {
-				result->emplace_back(j.value);
-			}
+			result->insert(result->end(), this->tree_.at(i).value.begin(), this->tree_.at(i).value.end());
+		}
+		return result;
+	}
+
+	std::shared_ptr<std::vector<uint8_t>> RAHTOctree::GetArithOctree() const {
+		std::vector<uint8_t> occupancy;
+		for (int i = 0; i < this->tree_height_ - 1; ++i) {
+			occupancy.insert(occupancy.end(), this->tree_.at(i).value.begin(), this->tree_.at(i).value.end());
 		}
+		static thread_local common::OccupancyEncoder enc;
+		enc.Encode(occupancy.data(), occupancy.size(), this->tree_height_ - 1);
+
+		auto result = std::make_shared<std::vector<uint8_t>>();
+		SaveTreeCore(this->tree_center_, this->tree_range_, this->tree_height_, result);
+		result->insert(result->end(), enc.GetBuffer(), enc.GetBuffer() + enc.GetBufferSize());
 		return result;
 	}
 
@@ -59,6 +71,18 @@ namespace octree {
 		return this->RAHT_result_;
 	}
 
+	const std::vector<uint8_t>& RAHTOctree::GetRAHTContext() const {
+		return this->contexts_;
+	}
+
+	std::vector<int> RAHTOctree::GetLevelSizes() const {
+		std::vector<int> sizes(this->tree_.size());
+		for (size_t i = 0; i < this->tree_.size(); ++i) {
+			sizes[i] = this->tree_[i].size();
+		}
+		return sizes;
+	}
+
 	void RAHTOctree::MakeTree() {
 		try {
 			if (!this->params_) {
@@ -98,13 +122,27 @@ namespace octree {
 				throw __EXCEPT__(BAD_PARAMETERS);
 			}
 
-			this->tree_.resize(this->tree_height_);
+			this->tree_.assign(this->tree_height_, OctreeLayer_t());
+			this->leaf_points_.clear();
+			this->leaf_offset_.clear();
 			max_range         = std::pow(2.0f, max_height);
 			this->tree_range_ = pcl::PointXYZ(max_range, max_range, max_range);
 
-			std::vector<int> points(this->source_cloud_->size());
-			std::iota(points.begin(), points.end(), 0);
-			this->AddNode(points, 0, this->tree_center_, this->tree_range_);
+			/* Morton keys of all branch layers fit in 64 bits, build the tree level by level, otherwise build it recursively */
+			if (this->tree_height_ - 1 <= MORTON_MAX_LEVEL) {
+				this->MortonBuild();
+			}
+			else {
+				std::vector<int> points(this->source_cloud_->size());
+				std::iota(points.begin(), points.end(), 0);
+				this->AddNode(points, 0, this->tree_center_, this->tree_range_);
+				this->leaf_offset_.emplace_back(this->leaf_points_.size());
+			}
+
+			/* Coefficient contexts and transform plan only depend on geometry */
+			RAHTContext(this->tree_, this->contexts_);
+			this->plan_.Build(this->tree_);
+			this->plan_.SetPool(RAHTPool(this->params_, this->plan_.size()));
 		}
 		catch (const common::Exception& e) {
 			e.Log();
@@ -112,6 +150,107 @@ namespace octree {
 		}
 	}
 
+	/*
+	 * @description : Stable LSD radix sort of (key, point index) pairs by the low _bits bits of key, 8 bits per pass.
+	 * @param  : {std::vector<uint64_t>& _keys}
+	 * @param  : {std::vector<int>& _points}
+	 * @param  : {int _bits}
+	 * @return : {}
+	 * */
+	static void MortonSort(std::vector<uint64_t>& _keys, std::vector<int>& _points, int _bits) {
+		const size_t          size = _keys.size();
+		std::vector<uint64_t> keys_buffer(size);
+		std::vector<int>      points_buffer(size);
+		for (int shift = 0; shift < _bits; shift += 8) {
+			size_t count[257] = {};
+			for (size_t i = 0; i < size; ++i) {
+				++count[((_keys[i] >> shift) & 0xff) + 1];
+			}
+			/* All keys share this digit, nothing to move */
+			if (count[((_keys[0] >> shift) & 0xff) + 1] == size) {
+				continue;
+			}
+			for (int i = 0; i < 256; ++i) {
+				count[i + 1] += count[i];
+			}
+			for (size_t i = 0; i < size; ++i) {
+				size_t pos         = count[(_keys[i] >> shift) & 0xff]++;
+				keys_buffer[pos]   = _keys[i];
+				points_buffer[pos] = _points[i];
+			}
+			_keys.swap(keys_buffer);
+			_points.swap(points_buffer);
+		}
+	}
+
+	void RAHTOctree::MortonBuild() {
+		const int    branch = this->tree_height_ - 1;
+		const size_t size   = this->source_cloud_->size();
+
+		/*
+		 * Morton key of each point is the path from root to its leaf, 3 bits per layer and root at the highest bits.
+		 * Every axis follows the same float comparisons and center updates as AddNode and SubSpaceCenter,
+		 * so each point falls into exactly the same leaf as the recursive building.
+		 * */
+		std::vector<uint64_t> keys(size);
+		std::vector<int>      points(size);
+		std::iota(points.begin(), points.end(), 0);
+		for (size_t i = 0; i < size; ++i) {
+			const auto& p = this->source_cloud_->at(i);
+			float       cx = this->tree_center_.x, cy = this->tree_center_.y, cz = this->tree_center_.z;
+			float       rx = this->tree_range_.x, ry = this->tree_range_.y, rz = this->tree_range_.z;
+			uint64_t    key = 0;
+			for (int h = 0; h < branch; ++h) {
+				rx /= 2.0f, ry /= 2.0f, rz /= 2.0f;
+				int bx = p.x > cx ? 0 : 1, by = p.y > cy ? 0 : 1, bz = p.z > cz ? 0 : 1;
+				cx  = bx ? cx - rx / 2.0f : cx + rx / 2.0f;
+				cy  = by ? cy - ry / 2.0f : cy + ry / 2.0f;
+				cz  = bz ? cz - rz / 2.0f : cz + rz / 2.0f;
+				key = (key << 3) | (bx << 2) | (by << 1) | bz;
+			}
+			keys[i] = key;
+		}
+
+		/* Stable sort, points in one leaf keep increasing index as AddNode does */
+		MortonSort(keys, points, 3 * branch);
+
+		/* Leaf layer, one node for each distinct key, points of a leaf are contiguous in sorted order */
+		std::vector<uint64_t> level_keys, upper_keys;
+		this->leaf_offset_.clear();
+		for (size_t i = 0; i < size; ++i) {
+			if (i == 0 || keys[i] != keys[i - 1]) {
+				level_keys.emplace_back(keys[i]);
+				this->leaf_offset_.emplace_back(i);
+			}
+		}
+		this->leaf_offset_.emplace_back(size);
+		this->leaf_points_.swap(points);
+		this->tree_.at(branch).assign(level_keys.size(), true);
+
+		/* Branch layers from bottom to top, sorted keys make each layer in the same order as AddNode emits */
+		for (int h = branch - 1; h >= 0; --h) {
+			upper_keys.clear();
+			for (size_t i = 0; i < level_keys.size(); ++i) {
+				if (i == 0 || (level_keys[i] >> 3) != (level_keys[i - 1] >> 3)) {
+					upper_keys.emplace_back(level_keys[i] >> 3);
+				}
+			}
+
+			auto&       layer = this->tree_.at(h);
+			const auto& lower = this->tree_.at(h + 1);
+			layer.assign(upper_keys.size(), false);
+			size_t child = 0;
+			for (size_t node = 0; node < upper_keys.size(); ++node) {
+				layer.child[node] = static_cast<int>(child);
+				for (; child < level_keys.size() && (level_keys[child] >> 3) == upper_keys[node]; ++child) {
+					layer.value[node] |= NodeValue[level_keys[child] & 0x07];
+					layer.weight[node] += lower.weight[child];
+				}
+			}
+			level_keys.swap(upper_keys);
+		}
+	}
+
 	void RAHTOctree::AddNode(std::vector<int>& _points, const int _height, const pcl::PointXYZ _center, const pcl::PointXYZ _range) {
 		try {
 			/* No points, return */
@@ -121,19 +260,18 @@ namespace octree {
 
 			/* Leaf layer */
 			if (_height == this->tree_height_ - 1) {
-				OctreeNode_t node;
-				node.value = 0xff;
+				auto& layer = this->tree_.at(_height);
+				layer.value.emplace_back(0xff);
+				layer.weight.emplace_back(1);
 				/* Record point index */
-				node.index.swap(_points);
-				/* Set weight */
-				node.weight[1] = 1;
-				/* Add node in this layer */
-				this->tree_.at(_height).emplace_back(node);
+				this->leaf_offset_.emplace_back(this->leaf_points_.size());
+				this->leaf_points_.insert(this->leaf_points_.end(), _points.begin(), _points.end());
+				std::vector<int>().swap(_points);
 			}
 			/* Branch layer */
 			else {
-				OctreeNode_t node;
-				node.index.resize(8, -1);
+				uint8_t value  = 0x00;
+				int     weight = 0;
 				/* Subrange : half of _range */
 				pcl::PointXYZ subrange(_range.x / 2.0f, _range.y / 2.0f, _range.z / 2.0f);
 				/* Point index in 8 subnodes */
@@ -150,34 +288,30 @@ namespace octree {
 				/* Release _points */
 				std::vector<int>().swap(_points);
 
+				/* Subnodes only add nodes into deeper layers before themselves, so children of this node are contiguous */
+				auto& lower = this->tree_.at(_height + 1);
+				int   child = lower.size();
+
 				/* For each subnode */
 				for (int i = 0; i < 8; ++i) {
 					/* If subnode is not empty */
 					if (!subnodes[i].empty()) {
 						/* Set i-th bit to 1 */
-						node.value |= NodeValue[i];
+						value |= NodeValue[i];
 						/* Compute subnode center */
 						pcl::PointXYZ subcenter = SubSpaceCenter(_center, subrange, i);
-						/* Next line will add an element in next layer */
-						node.index[i] = this->tree_.at(_height + 1).size();
 						/* Iteratively add subnode */
 						this->AddNode(subnodes[i], _height + 1, subcenter, subrange);
+						weight += lower.weight.back();
 					}
 					/* Else, empty subnode, do nothing */
 				}
 
-				/* 8 subnode weight, i.e., weight[8] to weight[15] */
-				for (int i = 0; i < 8; ++i) {
-					if (node.index[i] != -1) {
-						node.weight[i + 8] = this->tree_[_height + 1][node.index[i]].weight[1];
-					}
-				}
-				/* Compute weight[1] to weight[7] */
-				for (int i = 7; i > 0; --i) {
-					node.weight[i] = node.weight[NodeWeight[i][0]] + node.weight[NodeWeight[i][1]];
-				}
 				/* Add node in this layer */
-				this->tree_.at(_height).emplace_back(node);
+				auto& layer = this->tree_.at(_height);
+				layer.value.emplace_back(value);
+				layer.child.emplace_back(child);
+				layer.weight.emplace_back(weight);
 			}
 		}
 		catch (const common::Exception& e) {
@@ -186,6 +320,17 @@ namespace octree {
 		}
 	}
 
+	void RAHTOctree::LeafColors(const std::vector<common::ColorYUV>& _colors, common::ColorYUV* _leaves) const {
+		for (size_t n = 0; n + 1 < this->leaf_offset_.size(); ++n) {
+			common::ColorYUV temp;
+			for (int i = this->leaf_offset_[n]; i < this->leaf_offset_[n + 1]; ++i) {
+				temp += _colors[this->leaf_points_[i]];
+			}
+			temp /= this->leaf_offset_[n + 1] - this->leaf_offset_[n];
+			_leaves[n] = temp;
+		}
+	}
+
 	void RAHTOctree::RAHT() {
 		try {
 			if (!this->params_) {
@@ -201,44 +346,109 @@ namespace octree {
 			}
 
 			/* Do voxel downsampling for the leaf nodes */
-			for (auto& node : this->tree_.back()) {
-				common::ColorYUV temp;
-				for (auto i : node.index) {
-					temp += this->source_colors_->at(i);
+			const size_t leaves = this->tree_.back().size();
+			this->leaf_colors_.resize(leaves);
+			this->LeafColors(*this->source_colors_, this->leaf_colors_.data());
+
+			/* Result buffer is reused if the last one has been released by caller */
+			if (!this->RAHT_result_ || this->RAHT_result_.use_count() != 1) {
+				this->RAHT_result_ = std::make_shared<std::vector<common::ColorYUV>>();
+			}
+			this->RAHT_result_->resize(leaves);
+			this->plan_.Transform(this->leaf_colors_.data(), this->RAHT_result_->data());
+		}
+		catch (const common::Exception& e) {
+			e.Log();
+			throw __EXCEPT__(ERROR_OCCURED);
+		}
+	}
+
+	std::vector<std::shared_ptr<std::vector<common::ColorYUV>>> RAHTOctree::BatchRAHT(const std::vector<std::shared_ptr<std::vector<common::ColorYUV>>>& _colors) {
+		try {
+			if (!this->params_) {
+				throw __EXCEPT__(EMPTY_PARAMS);
+			}
+
+			if (this->tree_.size() != this->tree_height_ || this->tree_height_ <= 0) {
+				throw __EXCEPT__(EMPTY_OCTREE);
+			}
+
+			for (const auto& colors : _colors) {
+				if (!colors || colors->size() != this->source_cloud_->size()) {
+					throw __EXCEPT__(UNMATCHED_COLOR_SIZE);
 				}
-				temp /= node.index.size();
-				node.raht[0] = temp;
 			}
 
-			for (int i = this->tree_height_ - 2; i >= 0; --i) {
-				for (auto& node : this->tree_[i]) {
-					/* Collect subnodes' g_DC */
-					for (int idx = 0; idx < 8; ++idx) {
-						if (node.index[idx] != -1) {
-							node.raht[idx + 8] = this->tree_[i + 1][node.index[idx]].raht[0];
-						}
-					}
-					/* Do region-adaptive hierarchical transform */
-					node.HierarchicalTransform();
+			const size_t                                                leaves = this->tree_.back().size();
+			std::vector<std::shared_ptr<std::vector<common::ColorYUV>>> result(_colors.size());
+
+			/* Batches are independent, each one has its own scratch */
+			const size_t batches = (_colors.size() + RAHT_BATCH_FRAMES - 1) / RAHT_BATCH_FRAMES;
+			common::WorkerPool::Global(this->params_->thread_num).ParallelFor(batches, [&](size_t _batch) {
+				const size_t start  = _batch * RAHT_BATCH_FRAMES;
+				const int    frames = std::min(_colors.size() - start, static_cast<size_t>(RAHT_BATCH_FRAMES));
+
+				/* Voxel downsampling, frames x leaves matrix */
+				std::vector<common::ColorYUV> leaf_colors(leaves * frames);
+				for (int f = 0; f < frames; ++f) {
+					this->LeafColors(*_colors[start + f], leaf_colors.data() + f * leaves);
+				}
+
+				std::vector<common::ColorYUV*> coefficients(frames);
+				for (int f = 0; f < frames; ++f) {
+					result[start + f] = std::make_shared<std::vector<common::ColorYUV>>(leaves);
+					coefficients[f]   = result[start + f]->data();
 				}
+				std::vector<float> signals;
+				this->plan_.Transform(leaf_colors.data(), coefficients.data(), frames, signals);
+			});
+			return result;
+		}
+		catch (const common::Exception& e) {
+			e.Log();
+			throw __EXCEPT__(ERROR_OCCURED);
+		}
+	}
+
+	std::vector<std::shared_ptr<std::vector<int32_t>>> RAHTOctree::IntRAHT(const std::vector<std::shared_ptr<std::vector<common::ColorYUV>>>& _colors) {
+		try {
+			if (!this->params_) {
+				throw __EXCEPT__(EMPTY_PARAMS);
 			}
 
-			/* Collect all coefficients */
-			this->RAHT_result_ = std::make_shared<std::vector<common::ColorYUV>>();
-			/* g_DC */
-			this->RAHT_result_->emplace_back(this->tree_.front().front().raht[0]);
-			/* h_AC */
-			for (int i = 0; i < this->tree_height_ - 1; ++i) {
-				for (auto& node : this->tree_[i]) {
-					/* w1,w2 should both greater than 0 */
-					for (int idx = 1; idx < 8; ++idx) {
-						if (node.weight[NodeWeight[idx][0]] != 0 && node.weight[NodeWeight[idx][1]] != 0) {
-							this->RAHT_result_->emplace_back(node.raht[idx]);
-						}
-					}
+			if (this->tree_.size() != this->tree_height_ || this->tree_height_ <= 0) {
+				throw __EXCEPT__(EMPTY_OCTREE);
+			}
+
+			for (const auto& colors : _colors) {
+				if (!colors || colors->size() != this->source_cloud_->size()) {
+					throw __EXCEPT__(UNMATCHED_COLOR_SIZE);
 				}
 			}
-			std::reverse(this->RAHT_result_->begin(), this->RAHT_result_->end());
+
+			const size_t leaves = this->tree_.back().size();
+			if (leaves > INT_RAHT_MAX_LEAVES) {
+				throw __EXCEPT__(OUT_OF_RANGE);
+			}
+
+			std::vector<std::shared_ptr<std::vector<int32_t>>> result(_colors.size());
+			const float                                        scale = static_cast<float>(1 << INT_RAHT_FRAC_BITS);
+
+			/* Color sets are independent, each one has its own scratch */
+			common::WorkerPool::Global(this->params_->thread_num).ParallelFor(_colors.size(), [&](size_t f) {
+				/* Voxel downsampling, then round to fixed-point */
+				std::vector<common::ColorYUV> leaf_colors(leaves);
+				std::vector<int32_t>          fixed(3 * leaves), signals;
+				this->LeafColors(*_colors[f], leaf_colors.data());
+				for (size_t n = 0; n < leaves; ++n) {
+					fixed[3 * n]     = static_cast<int32_t>(std::lround(leaf_colors[n].y * scale));
+					fixed[3 * n + 1] = static_cast<int32_t>(std::lround(leaf_colors[n].u * scale));
+					fixed[3 * n + 2] = static_cast<int32_t>(std::lround(leaf_colors[n].v * scale));
+				}
+				result[f] = std::make_shared<std::vector<int32_t>>(3 * leaves);
+				this->plan_.IntTransform(fixed.data(), result[f]->data(), signals);
+			});
+			return result;
 		}
 		catch (const common::Exception& e) {
 			e.Log();
@@ -247,4 +457,3 @@ namespace octree {
 	}
 }  // namespace octree
 }  // namespace vvc
-
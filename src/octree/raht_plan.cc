@@ -0,0 +1,327 @@
+/* Copyright Notice.
+ *
+ * Please read the LICENSE file in the project root directory for details
+ * of the open source licenses referenced by this source code.
+ *
+ * Copyright: @ChenRP07, All Right Reserved.
+ *
+ * Author        : ChenRP07
+ * Description   : Implement of RAHTPlan, check octree.h for details.
+ * Create Time   : 2026/10/17 14:20
+ * Last Modified : 2026/10/17 14:20
+ *
+ */
+
+#include "octree/octree.h"
+
+namespace vvc {
+namespace octree {
+
+	/*
+	 * @description : Integer square root, result does not depend on floating-point precision
+	 * @param  : {uint64_t _x}
+	 * @return : {uint64_t} floor(√_x)
+	 * */
+	static uint64_t ISqrt(uint64_t _x) {
+		uint64_t r = static_cast<uint64_t>(std::sqrt(static_cast<double>(_x)));
+		while (r * r > _x) {
+			--r;
+		}
+		while ((r + 1) * (r + 1) <= _x) {
+			++r;
+		}
+		return r;
+	}
+
+	/*
+	 * @description : Fixed-point product of a lifting step, rounded to nearest
+	 * @param  : {int32_t _c} lifting coefficient
+	 * @param  : {int32_t _x} signal
+	 * @return : {int32_t}
+	 * */
+	static inline int32_t Lift(int32_t _c, int32_t _x) {
+		return static_cast<int32_t>((static_cast<int64_t>(_c) * _x + (int64_t{1} << (INT_RAHT_LIFT_BITS - 1))) >> INT_RAHT_LIFT_BITS);
+	}
+
+	common::WorkerPool* RAHTPool(const common::PVVCParam_t::Ptr& _params, size_t _leaves) {
+		if (_params->thread_num <= 1 || _params->octree.parallel_ths == 0 || _leaves < static_cast<size_t>(_params->octree.parallel_ths)) {
+			return nullptr;
+		}
+		return &common::WorkerPool::Global(_params->thread_num);
+	}
+
+	RAHTPlan::RAHTPlan() : butterflies_{}, leaves_{}, root_{}, signals_{}, liftings_{}, int_signals_{}, spans_{}, levels_{}, pool_{nullptr} {}
+
+	void RAHTPlan::Build(const std::vector<OctreeLayer_t>& _tree) {
+		try {
+			if (_tree.empty() || _tree.back().size() == 0) {
+				throw __EXCEPT__(EMPTY_OCTREE);
+			}
+
+			this->leaves_ = _tree.back().size();
+			this->butterflies_.clear();
+			this->butterflies_.reserve(this->leaves_ - 1);
+			this->liftings_.clear();
+			this->liftings_.reserve(this->leaves_ - 1);
+			this->spans_.assign(1, 0);
+			this->levels_.assign(1, 0);
+
+			/* Signal of each node in two adjacent layers, leaves are signal 0 to leaves_ - 1 */
+			std::vector<int> lower(this->leaves_), upper;
+			std::iota(lower.begin(), lower.end(), 0);
+
+			int weight[16], slot[16], h[8];
+			for (int i = static_cast<int>(_tree.size()) - 2; i >= 0; --i) {
+				const auto& layer = _tree[i];
+				const int   count = layer.size();
+				upper.resize(count);
+				for (int n = 0; n < count; ++n) {
+					/* Butterflies of different nodes in a layer are independent, cut a job at node boundary */
+					if (this->butterflies_.size() - this->spans_.back() >= RAHT_PARALLEL_GRAIN) {
+						this->spans_.push_back(this->butterflies_.size());
+					}
+					ExpandWeight(_tree, i, n, weight);
+					int child = layer.child[n];
+					for (int idx = 0; idx < 8; ++idx) {
+						slot[idx + 8] = (layer.value[n] & NodeValue[idx]) ? lower[child++] : -1;
+					}
+
+					/* h_ACs of this node start at count + child - n in transform order, g_DC first and from h_xyz to h_x, reversed in coding order */
+					int pos = this->leaves_ - 1 - (count + layer.child[n] - n);
+					for (int idx = 1; idx < 8; ++idx) {
+						if (weight[NodeWeight[idx][0]] != 0 && weight[NodeWeight[idx][1]] != 0) {
+							h[idx] = pos--;
+						}
+					}
+
+					/* X/Y/Z merge, a merge with an empty side just passes the other signal up */
+					for (int idx = 7; idx > 0; --idx) {
+						int w0 = weight[NodeWeight[idx][0]], w1 = weight[NodeWeight[idx][1]];
+						if (w0 != 0 && w1 != 0) {
+							/* Same as HaarTransform */
+							float base = std::sqrt(static_cast<float>(w0 + w1));
+							this->butterflies_.push_back(
+							    {slot[NodeWeight[idx][0]], slot[NodeWeight[idx][1]], h[idx], std::sqrt(static_cast<float>(w0)) / base, std::sqrt(static_cast<float>(w1)) / base});
+							/* cos θ and sin θ, then tan(θ / 2) = sin θ / (1 + cos θ), well-conditioned even if w0 >> w1, where 1 - cos θ would cancel */
+							const uint64_t one = uint64_t{1} << INT_RAHT_LIFT_BITS;
+							uint64_t       cosine = ISqrt((static_cast<uint64_t>(w0) << (2 * INT_RAHT_LIFT_BITS)) / (w0 + w1));
+							uint64_t       sine   = ISqrt((static_cast<uint64_t>(w1) << (2 * INT_RAHT_LIFT_BITS)) / (w0 + w1));
+							this->liftings_.push_back({static_cast<int32_t>((sine << INT_RAHT_LIFT_BITS) / (one + cosine)), static_cast<int32_t>(sine)});
+							/* g overwrites g0 */
+							slot[idx] = slot[NodeWeight[idx][0]];
+						}
+						else {
+							slot[idx] = w0 != 0 ? slot[NodeWeight[idx][0]] : slot[NodeWeight[idx][1]];
+						}
+					}
+					upper[n] = slot[1];
+				}
+				if (this->butterflies_.size() != this->spans_.back()) {
+					this->spans_.push_back(this->butterflies_.size());
+				}
+				this->levels_.push_back(this->spans_.size() - 1);
+				lower.swap(upper);
+			}
+			this->root_ = lower.front();
+			this->signals_.resize(3 * this->leaves_);
+		}
+		catch (const common::Exception& e) {
+			e.Log();
+			throw __EXCEPT__(ERROR_OCCURED);
+		}
+	}
+
+	size_t RAHTPlan::size() const {
+		return this->leaves_;
+	}
+
+	void RAHTPlan::SetPool(common::WorkerPool* _pool) {
+		this->pool_ = _pool;
+	}
+
+	template <typename Func> void RAHTPlan::Sweep(Func _job, bool _invert) const {
+		if (!this->pool_) {
+			_job(0, this->butterflies_.size());
+			return;
+		}
+
+		/* Layer by layer, jobs of a layer run in parallel, from root to leaves if _invert */
+		const size_t layers = this->levels_.size() - 1;
+		for (size_t t = 0; t < layers; ++t) {
+			const size_t l     = _invert ? layers - 1 - t : t;
+			const size_t first = this->levels_[l], count = this->levels_[l + 1] - first;
+			if (count == 1) {
+				_job(this->spans_[first], this->spans_[first + 1]);
+			}
+			else if (count > 1) {
+				this->pool_->ParallelFor(count, [&](size_t j) { _job(this->spans_[first + j], this->spans_[first + j + 1]); });
+			}
+		}
+	}
+
+	void RAHTPlan::Transform(const common::ColorYUV* _leaves, common::ColorYUV* _coefficients) {
+		float* s = this->signals_.data();
+		for (size_t i = 0; i < this->leaves_; ++i) {
+			s[3 * i] = _leaves[i].y, s[3 * i + 1] = _leaves[i].u, s[3 * i + 2] = _leaves[i].v;
+		}
+
+		this->Sweep(
+		    [&](size_t _begin, size_t _end) {
+			    for (size_t k = _begin; k < _end; ++k) {
+				    const auto& bf = this->butterflies_[k];
+				    float*      x  = s + 3 * bf.g0;
+				    float*      y  = s + 3 * bf.g1;
+				    _coefficients[bf.h].y = y[0] * bf.a - x[0] * bf.b;
+				    _coefficients[bf.h].u = y[1] * bf.a - x[1] * bf.b;
+				    _coefficients[bf.h].v = y[2] * bf.a - x[2] * bf.b;
+				    x[0] = x[0] * bf.a + y[0] * bf.b, x[1] = x[1] * bf.a + y[1] * bf.b, x[2] = x[2] * bf.a + y[2] * bf.b;
+			    }
+		    },
+		    false);
+
+		/* g_DC */
+		const float* dc   = s + 3 * this->root_;
+		auto&        g_DC = _coefficients[this->leaves_ - 1];
+		g_DC.y = dc[0], g_DC.u = dc[1], g_DC.v = dc[2];
+	}
+
+	void RAHTPlan::Transform(const common::ColorYUV* _leaves, common::ColorYUV* const* _coefficients, int _frames, std::vector<float>& _signals) const {
+		_signals.resize(3 * this->leaves_ * _frames);
+		float* s = _signals.data();
+		for (size_t i = 0; i < this->leaves_ * _frames; ++i) {
+			s[3 * i] = _leaves[i].y, s[3 * i + 1] = _leaves[i].u, s[3 * i + 2] = _leaves[i].v;
+		}
+
+		/* Each butterfly is loaded once and applied to all color sets, same expressions as above */
+		const size_t stride = 3 * this->leaves_;
+		this->Sweep(
+		    [&](size_t _begin, size_t _end) {
+			    for (size_t k = _begin; k < _end; ++k) {
+				    const auto& bf = this->butterflies_[k];
+				    float*      x  = s + 3 * bf.g0;
+				    float*      y  = s + 3 * bf.g1;
+				    for (int f = 0; f < _frames; ++f, x += stride, y += stride) {
+					    auto& h = _coefficients[f][bf.h];
+					    h.y     = y[0] * bf.a - x[0] * bf.b;
+					    h.u     = y[1] * bf.a - x[1] * bf.b;
+					    h.v     = y[2] * bf.a - x[2] * bf.b;
+					    x[0] = x[0] * bf.a + y[0] * bf.b, x[1] = x[1] * bf.a + y[1] * bf.b, x[2] = x[2] * bf.a + y[2] * bf.b;
+				    }
+			    }
+		    },
+		    false);
+
+		/* g_DC */
+		for (int f = 0; f < _frames; ++f) {
+			const float* dc   = s + f * stride + 3 * this->root_;
+			auto&        g_DC = _coefficients[f][this->leaves_ - 1];
+			g_DC.y = dc[0], g_DC.u = dc[1], g_DC.v = dc[2];
+		}
+	}
+
+	void RAHTPlan::InvertTransform(const float* _coefficients, common::ColorYUV* _leaves, const common::ColorYUV* _reference) {
+		float*       s = this->signals_.data();
+		const float *cy = _coefficients, *cu = cy + this->leaves_, *cv = cu + this->leaves_;
+
+		/* g_DC */
+		float* dc = s + 3 * this->root_;
+		dc[0] = cy[this->leaves_ - 1], dc[1] = cu[this->leaves_ - 1], dc[2] = cv[this->leaves_ - 1];
+
+		/* From root to leaves, same as InvertHaarTransform */
+		this->Sweep(
+		    [&](size_t _begin, size_t _end) {
+			    for (size_t k = _end; k > _begin; --k) {
+				    const auto& bf = this->butterflies_[k - 1];
+				    float*      x  = s + 3 * bf.g0;
+				    float*      y  = s + 3 * bf.g1;
+				    const float g[3]{x[0], x[1], x[2]};
+				    const float h[3]{cy[bf.h], cu[bf.h], cv[bf.h]};
+				    x[0] = g[0] * bf.a - h[0] * bf.b, x[1] = g[1] * bf.a - h[1] * bf.b, x[2] = g[2] * bf.a - h[2] * bf.b;
+				    y[0] = g[0] * bf.b + h[0] * bf.a, y[1] = g[1] * bf.b + h[1] * bf.a, y[2] = g[2] * bf.b + h[2] * bf.a;
+			    }
+		    },
+		    true);
+
+		if (_reference) {
+			/* Invert compensation, same as ColorYUV::operator+= */
+			for (size_t i = 0; i < this->leaves_; ++i) {
+				_leaves[i].y = s[3 * i] + _reference[i].y, _leaves[i].u = s[3 * i + 1] + _reference[i].u, _leaves[i].v = s[3 * i + 2] + _reference[i].v;
+			}
+		}
+		else {
+			for (size_t i = 0; i < this->leaves_; ++i) {
+				_leaves[i].y = s[3 * i], _leaves[i].u = s[3 * i + 1], _leaves[i].v = s[3 * i + 2];
+			}
+		}
+	}
+
+	void RAHTPlan::IntTransform(const int32_t* _leaves, int32_t* _coefficients, std::vector<int32_t>& _signals) const {
+		_signals.assign(_leaves, _leaves + 3 * this->leaves_);
+		int32_t* s = _signals.data();
+
+		this->Sweep(
+		    [&](size_t _begin, size_t _end) {
+			    for (size_t k = _begin; k < _end; ++k) {
+				    const auto& bf = this->butterflies_[k];
+				    const auto& lf = this->liftings_[k];
+				    int32_t*    x  = s + 3 * bf.g0;
+				    int32_t*    y  = s + 3 * bf.g1;
+				    for (int c = 0; c < 3; ++c) {
+					    int32_t g = x[c], h = y[c];
+					    g += Lift(lf.p, h);
+					    h -= Lift(lf.s, g);
+					    g += Lift(lf.p, h);
+					    x[c]                                   = g;
+					    _coefficients[c * this->leaves_ + bf.h] = h;
+				    }
+			    }
+		    },
+		    false);
+
+		/* g_DC */
+		for (int c = 0; c < 3; ++c) {
+			_coefficients[c * this->leaves_ + this->leaves_ - 1] = s[3 * this->root_ + c];
+		}
+	}
+
+	void RAHTPlan::IntInvertTransform(const int32_t* _coefficients, common::ColorYUV* _leaves, const common::ColorYUV* _reference) {
+		this->int_signals_.resize(3 * this->leaves_);
+		int32_t* s = this->int_signals_.data();
+
+		/* g_DC */
+		for (int c = 0; c < 3; ++c) {
+			s[3 * this->root_ + c] = _coefficients[c * this->leaves_ + this->leaves_ - 1];
+		}
+
+		/* From root to leaves, lifting steps in reversed order */
+		this->Sweep(
+		    [&](size_t _begin, size_t _end) {
+			    for (size_t k = _end; k > _begin; --k) {
+				    const auto& bf = this->butterflies_[k - 1];
+				    const auto& lf = this->liftings_[k - 1];
+				    int32_t*    x  = s + 3 * bf.g0;
+				    int32_t*    y  = s + 3 * bf.g1;
+				    for (int c = 0; c < 3; ++c) {
+					    int32_t g = x[c], h = _coefficients[c * this->leaves_ + bf.h];
+					    g -= Lift(lf.p, h);
+					    h += Lift(lf.s, g);
+					    g -= Lift(lf.p, h);
+					    x[c] = g, y[c] = h;
+				    }
+			    }
+		    },
+		    true);
+
+		/* Fixed-point to float is exact, scale is a power of two */
+		const float scale = 1.0f / static_cast<float>(1 << INT_RAHT_FRAC_BITS);
+		for (size_t i = 0; i < this->leaves_; ++i) {
+			_leaves[i].y = static_cast<float>(s[3 * i]) * scale, _leaves[i].u = static_cast<float>(s[3 * i + 1]) * scale, _leaves[i].v = static_cast<float>(s[3 * i + 2]) * scale;
+		}
+		if (_reference) {
+			for (size_t i = 0; i < this->leaves_; ++i) {
+				_leaves[i] += _reference[i];
+			}
+		}
+	}
+}  // namespace octree
+}  // namespace vvc
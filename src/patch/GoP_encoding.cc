@@ -17,7 +17,164 @@
 namespace vvc {
 namespace patch {
 
-	GoPEncoding::GoPEncoding() : params_{nullptr}, clock_{}, tree_{}, results_{}, fitting_cloud_{nullptr}, source_patches_{}, patch_colors_{} {}
+	/*
+	 * @description : Entropy code Y/U/V planes of _size symbols and append them to _payload, three substreams after a size table if _split
+	 * @param  : {const common::FIX_DATA_INT* _symbols} 3 * _size elements
+	 * @param  : {const uint8_t* _context} _size elements, used by arithmetic coder
+	 * @param  : {size_t _size}
+	 * @param  : {bool _split}
+	 * @param  : {bool _arith}
+	 * @param  : {std::vector<uint8_t>& _payload}
+	 * @return : {}
+	 * */
+	static void EncodeColor(const common::FIX_DATA_INT* _symbols, const uint8_t* _context, size_t _size, bool _split, bool _arith, std::vector<uint8_t>& _payload) {
+		/* Entropy encoders are reused by all slices coded in this worker thread */
+		static thread_local common::RLGREncoder        rlgr_enc;
+		static thread_local common::CoefficientEncoder coeff_enc;
+
+		const uint8_t* buffer{};
+		size_t         length{};
+		if (_split) {
+			/* Y U V substreams, each has its own adaptive state, size table of Y and U first */
+			const size_t table = _payload.size();
+			_payload.resize(table + common::PVVC_SLICE_COLOR_SPLIT_TABLE);
+			for (int c = 0; c < 3; ++c) {
+				if (_arith) {
+					coeff_enc.Encode(_symbols + c * _size, _context, _size, 1);
+					buffer = coeff_enc.GetBuffer(), length = coeff_enc.GetBufferSize();
+				}
+				else {
+					rlgr_enc.Encode(_symbols + c * _size, _size);
+					buffer = rlgr_enc.GetBuffer(), length = rlgr_enc.GetBufferSize();
+				}
+				if (c < 2) {
+					for (int b = 0; b < 4; ++b) {
+						_payload[table + c * 4 + b] = (length >> (24 - 8 * b)) & 0xff;
+					}
+				}
+				_payload.insert(_payload.end(), buffer, buffer + length);
+			}
+		}
+		else {
+			if (_arith) {
+				coeff_enc.Encode(_symbols, _context, _size, 3);
+				buffer = coeff_enc.GetBuffer(), length = coeff_enc.GetBufferSize();
+			}
+			else {
+				rlgr_enc.Encode(_symbols, 3 * _size);
+				buffer = rlgr_enc.GetBuffer(), length = rlgr_enc.GetBufferSize();
+			}
+			_payload.insert(_payload.end(), buffer, buffer + length);
+		}
+	}
+
+	/*
+	 * @description : Add coefficients to histogram of nonzero QPs, coefficient c is quantized to nonzero by QP q iff |c| >= q * _unit, i.e., it is counted in bin floor(|c| / _unit)
+	 * @param  : {const T* _coefficients}
+	 * @param  : {size_t _size}
+	 * @param  : {float _unit} half of step at QP 1 without dead zone, i.e., 1/2 for float coefficients, 2^(INT_RAHT_FRAC_BITS - 1) for fixed-point ones
+	 * @param  : {std::vector<size_t>& _histogram} 257 elements, last one is for QPs over 255
+	 * @return : {}
+	 * */
+	template <typename T> static void NonzeroHistogram(const T* _coefficients, size_t _size, float _unit, std::vector<size_t>& _histogram) {
+		const float scale = 1.0f / _unit;
+		for (size_t i = 0; i < _size; ++i) {
+			const float v = std::abs(static_cast<float>(_coefficients[i])) * scale;
+			++_histogram[v < 256.0f ? static_cast<int>(v) : 256];
+		}
+	}
+
+	/*
+	 * @description : Add coefficients to histogram of nonzero QPs by thresholds, coefficient c is quantized to nonzero by QP q iff |c| >= _thresholds[q],
+	 * i.e., it is counted in bin of the largest such q, used when step is not linear in QP
+	 * @param  : {const T* _coefficients}
+	 * @param  : {size_t _size}
+	 * @param  : {const std::vector<double>& _thresholds} 256 elements, nondecreasing, 0th one is 0
+	 * @param  : {std::vector<size_t>& _histogram} 257 elements
+	 * @return : {}
+	 * */
+	template <typename T> static void NonzeroHistogram(const T* _coefficients, size_t _size, const std::vector<double>& _thresholds, std::vector<size_t>& _histogram) {
+		for (size_t i = 0; i < _size; ++i) {
+			const double v = std::abs(static_cast<double>(_coefficients[i]));
+			++_histogram[std::upper_bound(_thresholds.begin() + 1, _thresholds.end(), v) - _thresholds.begin() - 1];
+		}
+	}
+
+	/*
+	 * @description : Count nonzero quantized coefficients at each QP from histogram of NonzeroHistogram
+	 * @param  : {std::vector<size_t> _histogram}
+	 * @return : {std::vector<size_t>} 256 elements, q-th one is nonzero number at QP q
+	 * */
+	static std::vector<size_t> NonzeroCounts(std::vector<size_t> _histogram) {
+		for (int q = 255; q >= 0; --q) {
+			_histogram[q] += _histogram[q + 1];
+		}
+		_histogram.pop_back();
+		return _histogram;
+	}
+
+	/*
+	 * @description : Modeled bytes of a slice, check RATE_NONZERO_BYTES for details
+	 * @param  : {size_t _nonzero}
+	 * @param  : {size_t _size} coefficients number, including zeros
+	 * @return : {double}
+	 * */
+	static double ModelBytes(size_t _nonzero, size_t _size) {
+		return _nonzero == 0 ? 0.0 : _nonzero * (RATE_NONZERO_BYTES + RATE_POSITION_BYTES * std::log2(static_cast<double>(_size) / _nonzero));
+	}
+
+	/*
+	 * @description : Choose QP of each slice for a color budget, QPs are _qp_i and _qp_p scaled by a common factor, the smallest factor whose modeled bytes fit is taken,
+	 * then QPs of single slices are lowered by one from the first slice on while the rest of budget allows
+	 * @param  : {const std::vector<std::vector<size_t>>& _nonzeros} NonzeroCounts of each slice, first slice is intra
+	 * @param  : {const std::vector<double>& _factor} correction of modeled bytes of each slice
+	 * @param  : {double _budget} bytes of color payloads
+	 * @param  : {uint8_t _qp_i}
+	 * @param  : {uint8_t _qp_p}
+	 * @return : {std::vector<uint8_t>} QP of each slice
+	 * */
+	static std::vector<uint8_t> ChooseQP(const std::vector<std::vector<size_t>>& _nonzeros, const std::vector<double>& _factor, double _budget, uint8_t _qp_i, uint8_t _qp_p) {
+		auto qp    = [](double _scale, uint8_t _base) { return std::min(std::max(static_cast<int>(std::lround(_base * _scale)), 1), 255); };
+		auto bytes = [&](double _scale) {
+			double sum = 0.0;
+			for (size_t i = 0; i < _nonzeros.size(); ++i) {
+				sum += _factor[i] * ModelBytes(_nonzeros[i][qp(_scale, i == 0 ? _qp_i : _qp_p)], _nonzeros[i][0]);
+			}
+			return sum;
+		};
+
+		/* Log of scale, from all QPs being 1 to all QPs being 255, modeled bytes never increase with it */
+		double lo = std::log(1.0 / std::max(_qp_i, _qp_p)), hi = std::log(255.0 / std::min(_qp_i, _qp_p));
+		if (bytes(std::exp(lo)) <= _budget) {
+			hi = lo;
+		}
+		else if (bytes(std::exp(hi)) <= _budget) {
+			for (int t = 0; t < RATE_SEARCH_STEPS; ++t) {
+				const double mid = (lo + hi) / 2.0;
+				(bytes(std::exp(mid)) <= _budget ? hi : lo) = mid;
+			}
+		}
+
+		std::vector<uint8_t> result(_nonzeros.size());
+		for (size_t i = 0; i < result.size(); ++i) {
+			result[i] = qp(std::exp(hi), i == 0 ? _qp_i : _qp_p);
+		}
+
+		/* Integer QPs are coarse steps of the scale, the rest of budget goes to the intra slice first since predictive slices are decoded on it */
+		double rest = _budget - bytes(std::exp(hi));
+		for (size_t i = 0; i < result.size(); ++i) {
+			if (result[i] > 1) {
+				const double delta = _factor[i] * (ModelBytes(_nonzeros[i][result[i] - 1], _nonzeros[i][0]) - ModelBytes(_nonzeros[i][result[i]], _nonzeros[i][0]));
+				if (delta <= rest) {
+					--result[i];
+					rest -= delta;
+				}
+			}
+		}
+		return result;
+	}
+
+	GoPEncoding::GoPEncoding() : params_{nullptr}, clock_{}, tree_{}, results_{}, fitting_cloud_{nullptr}, source_patches_{}, patch_colors_{}, stat_{}, budget_{} {}
 
 	void GoPEncoding::SetParams(common::PVVCParam_t::Ptr _param) {
 		try {
@@ -57,6 +214,19 @@ namespace patch {
 		}
 	}
 
+	void GoPEncoding::SetRateBudget(float _bytes) {
+		try {
+			if (!(_bytes >= 0.0f)) {
+				throw __EXCEPT__(BAD_PARAMETERS);
+			}
+			this->budget_ = _bytes;
+		}
+		catch (const common::Exception& e) {
+			e.Log();
+			throw __EXCEPT__(ERROR_OCCURED);
+		}
+	}
+
 	void GoPEncoding::SetFittingCloud(pcl::PointCloud<pcl::PointXYZRGB>::Ptr _cloud) {
 		try {
 			if (!_cloud || _cloud->empty()) {
@@ -119,6 +289,7 @@ namespace patch {
 			this->results_.resize(this->source_patches_.size());
 			for (int i = 0; i < this->source_patches_.size(); ++i) {
 				this->results_[i].type      = common::PVVC_SLICE_TYPE_DEFAULT_PREDICT;
+				this->results_[i].ext       = 0x00;
 				this->results_[i].mv        = this->source_patches_[i].mv.inverse();
 				this->results_[i].timestamp = this->source_patches_[i].timestamp;
 				this->results_[i].index     = this->source_patches_[i].index;
@@ -128,80 +299,346 @@ namespace patch {
 			/* First slice is an intra slice */
 			this->results_.front().type = common::PVVC_SLICE_TYPE_DEFAULT_INTRA;
 
-			/* Color interpolation */
+			/* Frames of this GoP are sub-tasks on the process-wide pool, workers which run out of GoPs pick them up */
+			auto& pool = common::WorkerPool::Global(this->params_->thread_num);
+
+			/* Color interpolation, a grid cell of edge √k holds about k points of a vox10 surface, so k-NN search mostly ends in adjacent cells */
+			const float cell = std::ceil(std::sqrt(static_cast<float>(this->params_->patch.interpolation_num)));
 			this->patch_colors_.resize(this->source_patches_.size());
-			for (int i = 0; i < this->source_patches_.size(); ++i) {
+			pool.ParallelFor(this->source_patches_.size(), [&](size_t i) {
 				this->patch_colors_[i] = std::make_shared<std::vector<common::ColorYUV>>();
-				/* Kdtree for nearest neighbors searching */
-				pcl::search::KdTree<pcl::PointXYZRGB> kdtree;
-				kdtree.setInputCloud(this->source_patches_[i].cloud);
+				/* Hashed voxel grid for nearest neighbors searching, source points are on an integer grid */
+				VoxelHash grid;
+				grid.SetInputCloud(this->source_patches_[i].cloud, cell);
 				/* k-NN search */
-				for (auto p : *(this->fitting_cloud_)) {
-					std::vector<int>   idx(this->params_->patch.interpolation_num);
-					std::vector<float> dis(this->params_->patch.interpolation_num);
-					kdtree.nearestKSearch(p, this->params_->patch.interpolation_num, idx, dis);
+				std::vector<int>   idx(this->params_->patch.interpolation_num);
+				std::vector<float> dis(this->params_->patch.interpolation_num);
+				this->patch_colors_[i]->reserve(this->fitting_cloud_->size());
+				for (const auto& p : *(this->fitting_cloud_)) {
+					grid.NearestKSearch(p, this->params_->patch.interpolation_num, idx, dis);
 					this->patch_colors_[i]->emplace_back(this->Interpolation(i, idx, dis));
 				}
-				if (i != 0) {
-					for (int color_idx = 0; color_idx < this->patch_colors_[0]->size(); ++color_idx) {
-						this->patch_colors_[i]->at(color_idx) -= this->patch_colors_[0]->at(color_idx);
-					}
+			});
+			/* Residual against the first frame, after all frames are interpolated */
+			pool.ParallelFor(this->source_patches_.size() - 1, [&](size_t i) {
+				for (int color_idx = 0; color_idx < this->patch_colors_[0]->size(); ++color_idx) {
+					this->patch_colors_[i + 1]->at(color_idx) -= this->patch_colors_[0]->at(color_idx);
 				}
-			}
+			});
 
 			/* Set geometry for RAHTOctree */
 			this->tree_.SetSourceCloud(this->fitting_cloud_);
 			this->tree_.MakeTree();
 
-			/* Get geometry */
+			/* Get geometry, occupancy bytes are optionally arithmetic coded, the smaller one is kept in auto mode */
 			auto geo_temp = this->tree_.GetOctree();
-			/* Optional Zstd encoding, valid when get real improvement in compression ratio */
+			if (this->params_->slice.geometry_coder != common::RAW_GEOMETRY_CODER) {
+				auto geo_arith = this->tree_.GetArithOctree();
+				if (this->params_->slice.geometry_coder == common::ARITHMETIC_GEOMETRY_CODER || geo_arith->size() < geo_temp->size()) {
+					geo_temp = geo_arith;
+					common::SetSliceExt(this->results_.front().type, this->results_.front().ext, common::PVVC_SLICE_EXT_CONFIG_GEO_ARITH);
+				}
+			}
+			/* Optional Zstd encoding, valid when get real improvement in compression ratio, skipped if estimation predicts no gain */
 			common::ZstdEncoder zstd_enc;
 			zstd_enc.SetParams(this->params_);
-			zstd_enc.Encode(geo_temp);
-			auto geo_zstd = zstd_enc.GetResult();
-			if (geo_zstd->size() < geo_temp->size()) {
+			zstd_enc.SetDictionary(common::ZSTD_DICT_GEOMETRY);
+			std::shared_ptr<std::vector<uint8_t>> geo_zstd;
+			if (zstd_enc.Estimate(geo_temp)) {
+				zstd_enc.Encode(geo_temp);
+				geo_zstd = zstd_enc.GetResult();
+				this->stat_.zstd_tried++;
+			}
+			else {
+				this->stat_.zstd_skipped++;
+			}
+			if (geo_zstd && geo_zstd->size() < geo_temp->size()) {
 				common::SetSliceType(this->results_.front().type, common::PVVC_SLICE_TYPE_CONFIG_GEO_ZSTD);
 				this->results_.front().geometry = geo_zstd;
+				this->stat_.zstd_used++;
 			}
 			else {
 				common::SetSliceType(this->results_.front().type, common::PVVC_SLICE_TYPE_CONFIG_GEO_NOZSTD);
 				this->results_.front().geometry = geo_temp;
 			}
+			this->stat_.geometry += this->results_.front().geometry->size();
+
+			/* Arithmetic coder uses contexts from octree level and node weight */
+			const uint8_t* context = this->tree_.GetRAHTContext().data();
+
+			/* Node number of each level, bounds of per level color substreams */
+			const std::vector<int> levels = this->tree_.GetLevelSizes();
+
+			/* Do RAHT, all patches share the octree and are transformed together, or by fixed-point integer RAHT */
+			std::vector<std::shared_ptr<std::vector<common::ColorYUV>>> RAHT_results;
+			std::vector<std::shared_ptr<std::vector<int32_t>>>          int_RAHT_results;
+			if (this->params_->slice.int_raht) {
+				int_RAHT_results = this->tree_.IntRAHT(this->patch_colors_);
+			}
+			else {
+				RAHT_results = this->tree_.BatchRAHT(this->patch_colors_);
+			}
+
+			/* Step of each level is scaled from QP and coefficients fall into a dead zone, uniform rounding by QP if both are off */
+			const bool level_quant = this->params_->slice.level_step != 0 || this->params_->slice.dead_zone != 0.0f;
+
+			/* Quantization of i-th slice by _qp, Y/U/V planes */
+			auto quantize = [&](size_t _i, uint8_t _qp, std::vector<common::FIX_DATA_INT>& _symbols) {
+				if (level_quant) {
+					/* Float coefficients are split into planes first, then level d, i.e., [size - n_d, size - n_{d-1}) of each plane, is quantized by its own step */
+					static thread_local std::vector<float> planes;
+					const size_t                           size = this->params_->slice.int_raht ? int_RAHT_results[_i]->size() / 3 : RAHT_results[_i]->size();
+					if (!this->params_->slice.int_raht) {
+						planes.resize(3 * size);
+						for (size_t n = 0; n < size; ++n) {
+							const auto& c = (*RAHT_results[_i])[n];
+							planes[n] = c.y, planes[size + n] = c.u, planes[2 * size + n] = c.v;
+						}
+					}
+					_symbols.resize(3 * size);
+					int upper = 0;
+					for (size_t d = 0; d < levels.size(); ++d) {
+						const size_t first = size - levels[d], count = levels[d] - upper;
+						const float  step  = common::LevelStep(_qp, this->params_->slice.level_step, levels.size(), d);
+						/* Fixed-point step is derived in integers as decoder does */
+						const int64_t fixed = common::LevelStepFixed(static_cast<int64_t>(_qp) << octree::INT_RAHT_FRAC_BITS, this->params_->slice.level_step, levels.size(), d);
+						const int64_t zone  = std::min<int64_t>(std::llround(fixed * this->params_->slice.dead_zone), fixed >> 1);
+						for (int c = 0; c < 3; ++c) {
+							const size_t offset = c * size + first;
+							if (this->params_->slice.int_raht) {
+								common::QuantizeFixedDeadZone(int_RAHT_results[_i]->data() + offset, _symbols.data() + offset, count, fixed, zone);
+							}
+							else {
+								common::QuantizeDeadZone(planes.data() + offset, _symbols.data() + offset, count, step, this->params_->slice.dead_zone);
+							}
+						}
+						upper = levels[d];
+					}
+				}
+				else if (this->params_->slice.int_raht) {
+					_symbols.resize(int_RAHT_results[_i]->size());
+					common::QuantizeFixed(int_RAHT_results[_i]->data(), _symbols.data(), _symbols.size(), static_cast<int64_t>(_qp) << octree::INT_RAHT_FRAC_BITS);
+				}
+				else {
+					_symbols.resize(RAHT_results[_i]->size() * 3);
+					common::QuantizeYUV(RAHT_results[_i]->data(), _symbols.data(), RAHT_results[_i]->size(), _qp);
+				}
+			};
+
+			/* Code i-th slice at _qp into coded[i], each call has its own Zstd encoder and statistic, so slices can be coded in parallel.
+			 * Rate control may try a slice at several QPs, the last try is kept */
+			std::vector<common::Slice>         coded(this->results_);
+			std::vector<uint8_t>               coded_qp(this->patch_colors_.size(), 0);
+			std::vector<common::EncoderStat_t> color_stat(this->patch_colors_.size());
+			auto                               code = [&](size_t i, uint8_t _qp) {
+				/* Quantization buffers are reused by all slices coded in this thread */
+				static thread_local std::vector<common::FIX_DATA_INT> RAHT_quant_result;
+				static thread_local std::vector<common::FIX_DATA_INT> level_symbols;
+
+				common::ZstdEncoder slice_zstd_enc;
+				slice_zstd_enc.SetParams(this->params_);
+				slice_zstd_enc.SetDictionary(common::ZSTD_DICT_COLOR);
+
+				/* Coding starts from the slice before any try */
+				auto& slice   = coded[i];
+				slice         = this->results_.at(i);
+				color_stat[i] = common::EncoderStat_t{};
+				coded_qp[i]   = _qp;
+
+				const size_t coeff_size = this->params_->slice.int_raht ? int_RAHT_results[i]->size() / 3 : RAHT_results[i]->size();
+				slice.size              = coeff_size;
+				slice.qp                = _qp;
+				quantize(i, _qp, RAHT_quant_result);
+
+				/* P slice whose residual quantizes to (almost) nothing is coded as skip, i.e., header only, decoder keeps colors of reference */
+				if (i != 0 && this->params_->slice.skip_ths >= 0.0f) {
+					const size_t nonzero = RAHT_quant_result.size() - std::count(RAHT_quant_result.begin(), RAHT_quant_result.end(), 0);
+					if (nonzero <= this->params_->slice.skip_ths * RAHT_quant_result.size()) {
+						common::SetSliceType(slice.type, common::PVVC_SLICE_TYPE_CONFIG_SKIP);
+						color_stat[i].skip_slices++;
+						return;
+					}
+				}
+
+				if (this->params_->slice.int_raht) {
+					common::SetSliceExt(slice.type, slice.ext, common::PVVC_SLICE_EXT_CONFIG_INT_RAHT);
+				}
+				/* Dead zone only changes encoder, decoder needs level step */
+				if (this->params_->slice.level_step != 0) {
+					common::SetSliceExt(slice.type, slice.ext, common::PVVC_SLICE_EXT_CONFIG_LEVEL_QUANT);
+					slice.level_step = this->params_->slice.level_step;
+				}
+				/* RLGR or arithmetic encoding, AUTO_COLOR_CODER tries both and keeps the smaller one */
+				std::shared_ptr<std::vector<uint8_t>> color_temp;
+				bool                                  color_arith{};
+				for (int coder = 0; coder < 2; ++coder) {
+					bool arith = coder == 1;
+					if ((arith && this->params_->slice.color_coder == common::RLGR_COLOR_CODER) || (!arith && this->params_->slice.color_coder == common::ARITHMETIC_COLOR_CODER)) {
+						continue;
+					}
+					auto payload = std::make_shared<std::vector<uint8_t>>();
+					if (this->params_->slice.level_color) {
+						/* Size table, then substreams from root to leaves, level d holds [coeff_size - n_d, coeff_size - n_{d-1}) of each plane */
+						payload->resize(levels.size() * common::PVVC_SLICE_COLOR_LEVEL_ENTRY);
+						int upper = 0;
+						for (size_t d = 0; d < levels.size(); ++d) {
+							const size_t first = coeff_size - levels[d], count = levels[d] - upper;
+							level_symbols.resize(3 * count);
+							for (int c = 0; c < 3; ++c) {
+								auto plane = RAHT_quant_result.begin() + c * coeff_size + first;
+								std::copy(plane, plane + count, level_symbols.begin() + c * count);
+							}
+							const size_t offset = payload->size();
+							EncodeColor(level_symbols.data(), context + first, count, this->params_->slice.split_color, arith, *payload);
+							const size_t length = payload->size() - offset;
+							for (int b = 0; b < common::PVVC_SLICE_COLOR_LEVEL_ENTRY; ++b) {
+								payload->at(d * common::PVVC_SLICE_COLOR_LEVEL_ENTRY + b) = (length >> (24 - 8 * b)) & 0xff;
+							}
+							upper = levels[d];
+						}
+					}
+					else {
+						EncodeColor(RAHT_quant_result.data(), context, coeff_size, this->params_->slice.split_color, arith, *payload);
+					}
+					if (!color_temp || payload->size() < color_temp->size()) {
+						color_temp  = payload;
+						color_arith = arith;
+					}
+				}
+				common::SetSliceType(slice.type, this->params_->slice.split_color ? common::PVVC_SLICE_TYPE_CONFIG_COLOR_SPLIT : common::PVVC_SLICE_TYPE_CONFIG_COLOR_NOSPLIT);
+				common::SetSliceType(slice.type, color_arith ? common::PVVC_SLICE_TYPE_CONFIG_COLOR_ARITH : common::PVVC_SLICE_TYPE_CONFIG_COLOR_RLGR);
+				if (this->params_->slice.level_color) {
+					common::SetSliceExt(slice.type, slice.ext, common::PVVC_SLICE_EXT_CONFIG_LEVEL_COLOR);
+				}
 
-			for (int i = 0; i < this->patch_colors_.size(); ++i) {
-				/* QP */
-				uint8_t QP = i == 0 ? this->params_->slice.qp_i : this->params_->slice.qp_p;
-
-				/* Do RAHT */
-				this->tree_.SetSourceColors(this->patch_colors_[i]);
-				this->tree_.RAHT();
-				auto RAHT_data            = this->tree_.GetRAHTResult();
-				this->results_.at(i).size = RAHT_data->size();
-				this->results_.at(i).qp   = QP;
-				auto RAHT_quant_result    = std::make_shared<std::vector<common::FIX_DATA_INT>>(RAHT_data->size() * 3);
-
-				/* Quantization */
-				for (int j = 0; j < RAHT_data->size(); ++j) {
-					RAHT_quant_result->at(j)                         = static_cast<common::FIX_DATA_INT>(std::round(RAHT_data->at(j).y / QP));
-					RAHT_quant_result->at(j + RAHT_data->size())     = static_cast<common::FIX_DATA_INT>(std::round(RAHT_data->at(j).u / QP));
-					RAHT_quant_result->at(j + 2 * RAHT_data->size()) = static_cast<common::FIX_DATA_INT>(std::round(RAHT_data->at(j).v / QP));
-				}
-				/* RLGR encoding */
-				common::RLGREncoder enc;
-				enc.Encode(RAHT_quant_result);
-				auto color_temp = enc.GetResult();
-				/* Optional Zstd encoding, valid whn get real improvement in compression ratio */
-				zstd_enc.Encode(color_temp);
-				auto color_zstd = zstd_enc.GetResult();
-				if (color_zstd->size() < color_temp->size()) {
-					common::SetSliceType(this->results_.at(i).type, common::PVVC_SLICE_TYPE_CONFIG_COLOR_ZSTD);
-					this->results_.at(i).color = color_zstd;
+				/* Optional Zstd encoding, valid whn get real improvement in compression ratio, never for level substreams since a Zstd frame must be decoded as a whole */
+				std::shared_ptr<std::vector<uint8_t>> color_zstd;
+				if (!this->params_->slice.level_color && slice_zstd_enc.Estimate(color_temp)) {
+					slice_zstd_enc.Encode(color_temp);
+					color_zstd = slice_zstd_enc.GetResult();
+					color_stat[i].zstd_tried++;
+				}
+				else {
+					color_stat[i].zstd_skipped++;
+				}
+				if (color_zstd && color_zstd->size() < color_temp->size()) {
+					common::SetSliceType(slice.type, common::PVVC_SLICE_TYPE_CONFIG_COLOR_ZSTD);
+					slice.color = color_zstd;
+					color_stat[i].zstd_used++;
 				}
 				else {
-					common::SetSliceType(this->results_.at(i).type, common::PVVC_SLICE_TYPE_CONFIG_COLOR_NOZSTD);
-					this->results_.at(i).color = color_temp;
+					common::SetSliceType(slice.type, common::PVVC_SLICE_TYPE_CONFIG_COLOR_NOZSTD);
+					slice.color = color_temp;
 				}
+				color_stat[i].color += slice.color->size();
+			};
+
+			/* QP of each slice, fixed or chosen by rate control */
+			std::vector<uint8_t> QPs(this->patch_colors_.size(), this->params_->slice.qp_p);
+			QPs.front() = this->params_->slice.qp_i;
+			if (this->budget_ > 0.0f) {
+				/* Nonzero coefficients of each slice at each QP */
+				std::vector<std::vector<size_t>> nonzeros(this->patch_colors_.size());
+				pool.ParallelFor(this->patch_colors_.size(), [&](size_t i) {
+					std::vector<size_t> histogram(257, 0);
+					const float         unit   = this->params_->slice.int_raht ? static_cast<float>(1 << (octree::INT_RAHT_FRAC_BITS - 1)) : 0.5f;
+					const int32_t*      ints   = this->params_->slice.int_raht ? int_RAHT_results[i]->data() : nullptr;
+					const float*        floats = this->params_->slice.int_raht ? nullptr : reinterpret_cast<const float*>(RAHT_results[i]->data());
+					const size_t        size   = this->params_->slice.int_raht ? int_RAHT_results[i]->size() / 3 : RAHT_results[i]->size();
+					if (!level_quant) {
+						ints ? NonzeroHistogram(ints, 3 * size, unit, histogram) : NonzeroHistogram(floats, 3 * size, unit, histogram);
+					}
+					else {
+						/* Step of level d is not linear in QP once it is clamped or rounded, so the threshold at each QP is built from the same step as quantize,
+						 * coefficient of level d is nonzero iff |c| >= (0.5 + dead_zone) * step of level d, exactly as QuantizeFixedDeadZone for fixed-point ones */
+						std::vector<double> thresholds(256, 0.0);
+						int                 upper = 0;
+						for (size_t d = 0; d < levels.size(); ++d) {
+							const size_t first = size - levels[d], count = levels[d] - upper;
+							for (int q = 1; q < 256; ++q) {
+								if (ints) {
+									const int64_t step = common::LevelStepFixed(static_cast<int64_t>(q) << octree::INT_RAHT_FRAC_BITS, this->params_->slice.level_step, levels.size(), d);
+									const int64_t zone = std::min<int64_t>(std::llround(step * this->params_->slice.dead_zone), step >> 1);
+									thresholds[q]      = static_cast<double>(step - (step >> 1) + zone);
+								}
+								else {
+									thresholds[q] = (0.5 + this->params_->slice.dead_zone) * common::LevelStep(q, this->params_->slice.level_step, levels.size(), d);
+								}
+							}
+							if (ints) {
+								for (int c = 0; c < 3; ++c) {
+									NonzeroHistogram(ints + c * size + first, count, thresholds, histogram);
+								}
+							}
+							else {
+								/* Y/U/V of a coefficient are interleaved */
+								NonzeroHistogram(floats + 3 * first, 3 * count, thresholds, histogram);
+							}
+							upper = levels[d];
+						}
+					}
+					nonzeros[i] = NonzeroCounts(std::move(histogram));
+				});
+
+				/* Geometry, headers and size tables are not affected by QP */
+				const size_t tables   = ((this->params_->slice.split_color ? common::PVVC_SLICE_COLOR_SPLIT_TABLE : 0) + (this->params_->slice.level_color ? common::PVVC_SLICE_COLOR_LEVEL_ENTRY : 0)) *
+				                      (this->params_->slice.level_color ? levels.size() : 1);
+				double overhead = this->results_.front().geometry->size();
+				for (const auto& result : this->results_) {
+					/* Header is measured by io::SliceHeaderSize with extension bits that code() sets */
+					common::Slice header = result;
+					if (this->params_->slice.int_raht) {
+						common::SetSliceExt(header.type, header.ext, common::PVVC_SLICE_EXT_CONFIG_INT_RAHT);
+					}
+					if (this->params_->slice.level_step != 0) {
+						common::SetSliceExt(header.type, header.ext, common::PVVC_SLICE_EXT_CONFIG_LEVEL_QUANT);
+					}
+					if (this->params_->slice.level_color) {
+						common::SetSliceExt(header.type, header.ext, common::PVVC_SLICE_EXT_CONFIG_LEVEL_COLOR);
+					}
+					overhead += io::SliceHeaderSize(header) + tables;
+				}
+				const double budget = std::max(this->budget_ - overhead, 0.0);
+
+				std::vector<double> factor(this->patch_colors_.size(), 1.0);
+				QPs = ChooseQP(nonzeros, factor, budget, this->params_->slice.qp_i, this->params_->slice.qp_p);
+
+				/* First pass, slices are really coded at the chosen QPs, so coder choice and Zstd are included, their bytes correct the model of
+				 * each slice around them, then QPs are chosen again, only slices whose QP moves are coded again */
+				for (int pass = 0; this->params_->rate.first_pass && pass < RATE_PASSES; ++pass) {
+					/* Slices whose QP has moved, a slice with empty model is left to the final coding since its bytes cannot correct the model,
+					 * so first pass ends once no slice is left, otherwise such a slice would keep QPs != coded_qp forever */
+					std::vector<size_t> moved;
+					for (size_t i = 0; i < this->patch_colors_.size(); ++i) {
+						if (QPs[i] != coded_qp[i] && ModelBytes(nonzeros[i][QPs[i]], nonzeros[i][0]) > 0.0) {
+							moved.emplace_back(i);
+						}
+					}
+					if (moved.empty()) {
+						break;
+					}
+					pool.ParallelFor(moved.size(), [&](size_t k) {
+						const size_t i     = moved[k];
+						const double model = ModelBytes(nonzeros[i][QPs[i]], nonzeros[i][0]);
+						code(i, QPs[i]);
+						/* Skip slice tells nothing about the model */
+						if (coded[i].color) {
+							factor[i] = std::max(static_cast<double>(coded[i].color->size()) - tables, 1.0) / model;
+						}
+					});
+					QPs = ChooseQP(nonzeros, factor, budget, this->params_->slice.qp_i, this->params_->slice.qp_p);
+				}
+			}
+
+			/* Slices not coded at their final QP yet, statistics are summed in order after all of them are done */
+			pool.ParallelFor(this->patch_colors_.size(), [&](size_t i) {
+				if (coded_qp[i] != QPs[i]) {
+					code(i, QPs[i]);
+				}
+			});
+			this->results_ = std::move(coded);
+			for (const auto& s : color_stat) {
+				this->stat_ += s;
 			}
 		}
 		catch (const common::Exception& e) {
@@ -213,5 +650,9 @@ namespace patch {
 	std::vector<common::Slice> GoPEncoding::GetResults() {
 		return this->results_;
 	}
+
+	common::EncoderStat_t GoPEncoding::GetStat() const {
+		return this->stat_;
+	}
 }  // namespace patch
 }  // namespace vvc
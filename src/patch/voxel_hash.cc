@@ -0,0 +1,206 @@
+/* Copyright Notice.
+ *
+ * Please read the LICENSE file in the project root directory for details
+ * of the open source licenses referenced by this source code.
+ *
+ * Copyright: @ChenRP07, All Right Reserved.
+ *
+ * Author        : ChenRP07
+ * Description   : Implement of VoxelHash, check patch.h for details.
+ * Create Time   : 2026/10/17 18:40
+ * Last Modified : 2026/10/17 18:40
+ *
+ */
+
+#include "patch/patch.h"
+
+namespace vvc {
+namespace patch {
+
+	/* Cell coordinates are offset to be non-negative and packed into 21 bits each */
+	static const int VOXEL_HASH_OFFSET = 1 << 20;
+
+	/* Key of empty slots, no cell packs to it */
+	static const uint64_t VOXEL_HASH_EMPTY = ~uint64_t{0};
+
+	static inline uint64_t PackCell(int _x, int _y, int _z) {
+		return (static_cast<uint64_t>(_x + VOXEL_HASH_OFFSET) << 42) | (static_cast<uint64_t>(_y + VOXEL_HASH_OFFSET) << 21) | static_cast<uint64_t>(_z + VOXEL_HASH_OFFSET);
+	}
+
+	static inline uint64_t HashCell(uint64_t _key) {
+		uint64_t h = _key * 0x9e3779b97f4a7c15ull;
+		return h ^ (h >> 29);
+	}
+
+	VoxelHash::VoxelHash() : cloud_{nullptr}, cell_{1.0f}, order_{}, points_{}, keys_{}, ranges_{}, mask_{0}, lower_{}, upper_{} {}
+
+	void VoxelHash::SetInputCloud(const pcl::PointCloud<pcl::PointXYZRGB>::Ptr& _cloud, float _cell) {
+		try {
+			if (!_cloud || _cloud->empty()) {
+				throw __EXCEPT__(EMPTY_POINT_CLOUD);
+			}
+			if (!(_cell > 0.0f)) {
+				throw __EXCEPT__(BAD_PARAMETERS);
+			}
+			this->cloud_ = _cloud;
+			this->cell_  = _cell;
+
+			/* Cell key of each point, sorted so that points of a cell are contiguous */
+			const float                          inv = 1.0f / _cell;
+			std::vector<std::pair<uint64_t, int>> cells(_cloud->size());
+			for (int k = 0; k < 3; ++k) {
+				this->lower_[k] = VOXEL_HASH_OFFSET - 1, this->upper_[k] = -VOXEL_HASH_OFFSET;
+			}
+			for (size_t i = 0; i < _cloud->size(); ++i) {
+				const auto& p = (*_cloud)[i];
+				int         c[3]{static_cast<int>(std::floor(p.x * inv)), static_cast<int>(std::floor(p.y * inv)), static_cast<int>(std::floor(p.z * inv))};
+				for (int k = 0; k < 3; ++k) {
+					if (c[k] < -VOXEL_HASH_OFFSET || c[k] >= VOXEL_HASH_OFFSET) {
+						throw __EXCEPT__(BAD_PARAMETERS);
+					}
+					this->lower_[k] = std::min(this->lower_[k], c[k]), this->upper_[k] = std::max(this->upper_[k], c[k]);
+				}
+				cells[i] = {PackCell(c[0], c[1], c[2]), static_cast<int>(i)};
+			}
+			std::sort(cells.begin(), cells.end());
+
+			size_t occupied = 1;
+			for (size_t i = 1; i < cells.size(); ++i) {
+				occupied += cells[i].first != cells[i - 1].first;
+			}
+
+			/* Open addressing table, at most half full */
+			size_t size = 16;
+			while (size < 2 * occupied) {
+				size <<= 1;
+			}
+			this->mask_ = size - 1;
+			this->keys_.assign(size, VOXEL_HASH_EMPTY);
+			this->ranges_.assign(size, {0, 0});
+			this->order_.resize(cells.size());
+			this->points_.resize(cells.size());
+			for (size_t i = 0, j = 0; i < cells.size(); i = j) {
+				for (j = i; j < cells.size() && cells[j].first == cells[i].first; ++j) {
+					const auto& p    = (*_cloud)[cells[j].second];
+					this->order_[j]  = cells[j].second;
+					this->points_[j] = pcl::PointXYZ(p.x, p.y, p.z);
+				}
+				uint64_t slot = HashCell(cells[i].first) & this->mask_;
+				while (this->keys_[slot] != VOXEL_HASH_EMPTY) {
+					slot = (slot + 1) & this->mask_;
+				}
+				this->keys_[slot]   = cells[i].first;
+				this->ranges_[slot] = {static_cast<int>(i), static_cast<int>(j)};
+			}
+		}
+		catch (const common::Exception& e) {
+			e.Log();
+			throw __EXCEPT__(ERROR_OCCURED);
+		}
+	}
+
+	const std::pair<int, int>* VoxelHash::Find(uint64_t _key) const {
+		for (uint64_t slot = HashCell(_key) & this->mask_;; slot = (slot + 1) & this->mask_) {
+			if (this->keys_[slot] == _key) {
+				return &this->ranges_[slot];
+			}
+			if (this->keys_[slot] == VOXEL_HASH_EMPTY) {
+				return nullptr;
+			}
+		}
+	}
+
+	int VoxelHash::NearestKSearch(const pcl::PointXYZRGB& _point, int _k, std::vector<int>& _idx, std::vector<float>& _dis) const {
+		_idx.clear(), _dis.clear();
+		if (!this->cloud_ || _k <= 0) {
+			return 0;
+		}
+		const size_t k = std::min<size_t>(_k, this->cloud_->size());
+		_idx.resize(k), _dis.resize(k);
+		size_t found = 0;
+
+		const float p[3]{_point.x, _point.y, _point.z};
+
+		/* Keep k nearest ones sorted by insertion, k is small, ties are broken by smaller index so result does not depend on cell size.
+		 * Cells farther than the k-th one are not looked up */
+		auto visit = [&](int _x, int _y, int _z) {
+			if (found == k) {
+				const int c[3]{_x, _y, _z};
+				float     box = 0.0f;
+				for (int a = 0; a < 3; ++a) {
+					const float gap = std::max({c[a] * this->cell_ - p[a], p[a] - (c[a] + 1) * this->cell_, 0.0f});
+					box += gap * gap;
+				}
+				if (box > _dis[k - 1]) {
+					return;
+				}
+			}
+			const auto* range = this->Find(PackCell(_x, _y, _z));
+			if (!range) {
+				return;
+			}
+			for (int i = range->first; i < range->second; ++i) {
+				const auto& q     = this->points_[i];
+				const int   index = this->order_[i];
+				const float dx = q.x - _point.x, dy = q.y - _point.y, dz = q.z - _point.z;
+				const float d  = dx * dx + dy * dy + dz * dz;
+				if (found == k && (d > _dis[k - 1] || (d == _dis[k - 1] && index > _idx[k - 1]))) {
+					continue;
+				}
+				size_t pos = found < k ? found++ : k - 1;
+				for (; pos > 0 && (_dis[pos - 1] > d || (_dis[pos - 1] == d && _idx[pos - 1] > index)); --pos) {
+					_dis[pos] = _dis[pos - 1], _idx[pos] = _idx[pos - 1];
+				}
+				_dis[pos] = d, _idx[pos] = index;
+			}
+		};
+
+		int c[3]{};
+		for (int a = 0; a < 3; ++a) {
+			/* Clamp to the occupied box, the shell bound below stays valid since it is computed from the real position */
+			c[a] = static_cast<int>(std::floor(std::max(std::min(p[a] / this->cell_, static_cast<float>(VOXEL_HASH_OFFSET)), -static_cast<float>(VOXEL_HASH_OFFSET))));
+			c[a] = std::max(std::min(c[a], this->upper_[a]), this->lower_[a]);
+		}
+
+		for (int r = 0;; ++r) {
+			/* Cells of shell r, i.e., Chebyshev distance r from center cell, clipped by occupied box */
+			const int x0 = std::max(c[0] - r, this->lower_[0]), x1 = std::min(c[0] + r, this->upper_[0]);
+			const int y0 = std::max(c[1] - r, this->lower_[1]), y1 = std::min(c[1] + r, this->upper_[1]);
+			const int z0 = std::max(c[2] - r, this->lower_[2]), z1 = std::min(c[2] + r, this->upper_[2]);
+			for (int x = x0; x <= x1; ++x) {
+				for (int y = y0; y <= y1; ++y) {
+					if (std::abs(x - c[0]) == r || std::abs(y - c[1]) == r) {
+						for (int z = z0; z <= z1; ++z) {
+							visit(x, y, z);
+						}
+					}
+					else {
+						if (c[2] - r >= this->lower_[2]) {
+							visit(x, y, c[2] - r);
+						}
+						if (c[2] + r <= this->upper_[2]) {
+							visit(x, y, c[2] + r);
+						}
+					}
+				}
+			}
+
+			/* All occupied cells are scanned */
+			if (x0 == this->lower_[0] && x1 == this->upper_[0] && y0 == this->lower_[1] && y1 == this->upper_[1] && z0 == this->lower_[2] && z1 == this->upper_[2]) {
+				break;
+			}
+			/* Points out of scanned cells are farther than distance from _point to the boundary of scanned box */
+			if (found == k) {
+				float bound = std::numeric_limits<float>::max();
+				for (int a = 0; a < 3; ++a) {
+					bound = std::min({bound, p[a] - (c[a] - r) * this->cell_, (c[a] + r + 1) * this->cell_ - p[a]});
+				}
+				if (bound > 0.0f && _dis[k - 1] < bound * bound) {
+					break;
+				}
+			}
+		}
+		return static_cast<int>(found);
+	}
+}  // namespace patch
+}  // namespace vvc
@@ -0,0 +1,272 @@
+#include "common/common.h"
+#include "common/entropy_codec.h"
+#include "common/quantization.h"
+#include "io/slice_io.h"
+#include "octree/octree.h"
+
+#include <filesystem>
+#include <random>
+
+/*
+ * CPU-only benchmark of entropy codecs, RLGR, arithmetic coefficient coder and Zstd, output is JSON on stdout.
+ * RLGR is decoded by the word-at-a-time path ("rlgr") and the legacy bit-by-bit path ("rlgr_bitwise"), encode time is shared.
+ * Sources :
+ *   laplacian : Laplacian coefficients with scale 32, quantized by each QP.
+ *   raht      : RAHT coefficients of a synthetic voxelized sphere with smooth colors and noise, quantized by each QP.
+ *   slices    : color symbols and geometry of real .slice files in [slice_dir], optional.
+ * For RLGR and arithmetic coder, input is the FIX_DATA_INT symbols; for Zstd, input is the RLGR stream of same symbols,
+ * or raw octree bytes for geometry. MB/s is input bytes per second, ratio is input bytes / coded bytes.
+ * Usage : bench_xxx [symbol_count] [repeat] [slice_dir]
+ * */
+
+using namespace vvc;
+
+/* One coding case */
+struct Source {
+	std::string                       name;     /* Source name */
+	int                               qp;       /* Quantization step, -1 if mixed */
+	std::vector<common::FIX_DATA_INT> symbols;  /* Quantized coefficients */
+	std::vector<uint8_t>              contexts; /* Context of each symbol, for arithmetic coder */
+};
+
+/* One benchmark result */
+struct Record {
+	std::string source, coder;
+	int         qp;
+	size_t      symbols, input_bytes, coded_bytes;
+	float       encode_s, decode_s;
+	bool        match;
+};
+
+static std::vector<Record> records;
+
+/*
+ * @description : Time _repeat runs of _func, return seconds of one run
+ * */
+template <typename Func>
+static float Timing(int _repeat, Func _func) {
+	common::PVVCTime_t clock;
+	clock.SetTimeBegin();
+	for (int r = 0; r < _repeat; ++r) {
+		_func();
+	}
+	clock.SetTimeEnd();
+	return clock.GetTimeS() / _repeat;
+}
+
+/*
+ * @description : Benchmark RLGR, arithmetic coder and Zstd on RLGR stream for one source
+ * */
+static void BenchSource(const Source& _src, int _repeat, common::PVVCParam_t::Ptr _param) {
+	int                               size = _src.symbols.size();
+	std::vector<common::FIX_DATA_INT> result(size);
+	size_t                            input = size * sizeof(common::FIX_DATA_INT);
+
+	/* RLGR */
+	common::RLGREncoder rlgr_enc;
+	common::RLGRDecoder rlgr_dec;
+	float               enc_s = Timing(_repeat, [&]() { rlgr_enc.Encode(_src.symbols.data(), size); });
+	std::vector<uint8_t> rlgr_stream(rlgr_enc.GetBuffer(), rlgr_enc.GetBuffer() + rlgr_enc.GetBufferSize());
+	size_t               consumed{};
+	float dec_s = Timing(_repeat, [&]() { rlgr_dec.Decode(rlgr_stream.data(), rlgr_stream.size(), result.data(), result.size(), size, consumed); });
+	records.push_back({_src.name, "rlgr", _src.qp, _src.symbols.size(), input, rlgr_stream.size(), enc_s, dec_s, result == _src.symbols});
+
+	/* Legacy bit-by-bit RLGR decoder, same stream, to compare with the word-at-a-time path above */
+	auto shared_stream = std::make_shared<std::vector<uint8_t>>(rlgr_stream);
+	dec_s              = Timing(_repeat, [&]() { rlgr_dec.Decode(shared_stream, size); });
+	result             = *rlgr_dec.GetResult();
+	records.push_back({_src.name, "rlgr_bitwise", _src.qp, _src.symbols.size(), input, rlgr_stream.size(), enc_s, dec_s, result == _src.symbols});
+
+	/* Arithmetic coder, one channel */
+	common::CoefficientEncoder arith_enc;
+	common::CoefficientDecoder arith_dec;
+	enc_s = Timing(_repeat, [&]() { arith_enc.Encode(_src.symbols.data(), _src.contexts.data(), size, 1); });
+	std::fill(result.begin(), result.end(), 0);
+	dec_s = Timing(_repeat, [&]() { arith_dec.Decode(arith_enc.GetBuffer(), arith_enc.GetBufferSize(), _src.contexts.data(), result.data(), size, 1); });
+	records.push_back({_src.name, "arithmetic", _src.qp, _src.symbols.size(), input, arith_enc.GetBufferSize(), enc_s, dec_s, result == _src.symbols});
+
+	/* Zstd on RLGR stream, as color payload of a slice */
+	auto stream = std::make_shared<std::vector<uint8_t>>(rlgr_stream);
+	common::ZstdEncoder zstd_enc;
+	zstd_enc.SetParams(_param);
+	enc_s = Timing(_repeat, [&]() { zstd_enc.Encode(stream); });
+	auto                 zstd_stream = zstd_enc.GetResult();
+	std::vector<uint8_t> zstd_result(stream->size());
+	common::ZstdDecoder  zstd_dec;
+	size_t               length{};
+	dec_s = Timing(_repeat, [&]() { length = zstd_dec.Decode(zstd_stream->data(), zstd_stream->size(), zstd_result.data(), zstd_result.size(), consumed); });
+	records.push_back({_src.name, "zstd", _src.qp, _src.symbols.size(), stream->size(), zstd_stream->size(), enc_s, dec_s, length == stream->size() && zstd_result == *stream});
+}
+
+/*
+ * @description : Benchmark Zstd on raw bytes, e.g., octree geometry
+ * */
+static void BenchBytes(const std::string& _name, std::shared_ptr<std::vector<uint8_t>> _data, int _repeat, common::PVVCParam_t::Ptr _param) {
+	common::ZstdEncoder zstd_enc;
+	zstd_enc.SetParams(_param);
+	float                enc_s  = Timing(_repeat, [&]() { zstd_enc.Encode(_data); });
+	auto                 stream = zstd_enc.GetResult();
+	std::vector<uint8_t> result(_data->size());
+	common::ZstdDecoder  zstd_dec;
+	size_t               length{}, consumed{};
+	float                dec_s = Timing(_repeat, [&]() { length = zstd_dec.Decode(stream->data(), stream->size(), result.data(), result.size(), consumed); });
+	records.push_back({_name, "zstd", -1, 0, _data->size(), stream->size(), enc_s, dec_s, length == _data->size() && result == *_data});
+}
+
+/*
+ * @description : RAHT coefficients and contexts of a voxelized sphere, about _points points
+ * */
+static void SyntheticRAHT(int _points, common::PVVCParam_t::Ptr _param, std::vector<common::ColorYUV>& _coefficients, std::vector<uint8_t>& _contexts) {
+	std::mt19937                          gen(0x5eed);
+	std::normal_distribution<float>       noise(0.0f, 4.0f);
+	int                                   radius = std::max(2, static_cast<int>(std::sqrt(_points / (4.0f * M_PI))));
+	pcl::PointCloud<pcl::PointXYZRGB>::Ptr cloud(new pcl::PointCloud<pcl::PointXYZRGB>());
+	for (int x = -radius - 1; x <= radius + 1; ++x) {
+		for (int y = -radius - 1; y <= radius + 1; ++y) {
+			for (int z = -radius - 1; z <= radius + 1; ++z) {
+				float d = std::sqrt(static_cast<float>(x * x + y * y + z * z)) - radius;
+				if (d < 0.0f || d >= 1.0f) {
+					continue;
+				}
+				/* Smooth color field plus sensor noise */
+				pcl::PointXYZRGB p;
+				p.x = x, p.y = y, p.z = z;
+				p.r = static_cast<uint8_t>(std::clamp(128.0f + 100.0f * std::sin(x * 0.05f) + noise(gen), 0.0f, 255.0f));
+				p.g = static_cast<uint8_t>(std::clamp(128.0f + 100.0f * std::cos(y * 0.04f) + noise(gen), 0.0f, 255.0f));
+				p.b = static_cast<uint8_t>(std::clamp(128.0f + 60.0f * std::sin((x + z) * 0.03f) + noise(gen), 0.0f, 255.0f));
+				cloud->emplace_back(p);
+			}
+		}
+	}
+	octree::RAHTOctree tree;
+	tree.SetParams(_param);
+	tree.SetSourceCloud(cloud);
+	tree.MakeTree();
+	auto colors = std::make_shared<std::vector<common::ColorYUV>>();
+	for (auto& p : *cloud) {
+		colors->emplace_back(p);
+	}
+	tree.SetSourceColors(colors);
+	tree.RAHT();
+	_coefficients = *tree.GetRAHTResult();
+	_contexts     = tree.GetRAHTContext();
+}
+
+/*
+ * @description : Color symbols and geometry of .slice files in _dir, arithmetic coded color is skipped since it needs octree contexts
+ * */
+static void LoadSlices(const std::string& _dir, Source& _src, std::shared_ptr<std::vector<uint8_t>> _geometry) {
+	common::RLGRDecoder rlgr_dec;
+	common::ZstdDecoder zstd_dec;
+	for (auto& entry : std::filesystem::directory_iterator(_dir)) {
+		if (!entry.is_regular_file() || entry.path().extension() != ".slice") {
+			continue;
+		}
+		common::Slice slice;
+		io::LoadSlice(slice, entry.path().string());
+		if (slice.geometry) {
+			auto geometry = slice.geometry;
+			if (common::CheckSliceType(slice.type, common::PVVC_SLICE_TYPE_GEO_ZSTD)) {
+				zstd_dec.Decode(slice.geometry);
+				geometry = zstd_dec.GetResult();
+			}
+			_geometry->insert(_geometry->end(), geometry->begin(), geometry->end());
+		}
+		if (!slice.color || common::CheckSliceType(slice.type, common::PVVC_SLICE_TYPE_COLOR_ARITH) || common::CheckSliceExt(slice.type, slice.ext, common::PVVC_SLICE_EXT_LEVEL_COLOR)) {
+			continue;
+		}
+		auto color = slice.color;
+		if (common::CheckSliceType(slice.type, common::PVVC_SLICE_TYPE_COLOR_ZSTD)) {
+			zstd_dec.Decode(slice.color);
+			color = zstd_dec.GetResult();
+		}
+		size_t offset = _src.symbols.size();
+		_src.symbols.resize(offset + 3 * slice.size);
+		if (common::CheckSliceType(slice.type, common::PVVC_SLICE_TYPE_COLOR_SPLIT)) {
+			const uint8_t* data = color->data() + common::PVVC_SLICE_COLOR_SPLIT_TABLE;
+			size_t         left = color->size() - common::PVVC_SLICE_COLOR_SPLIT_TABLE, consumed{};
+			for (int c = 0; c < 3; ++c) {
+				size_t length = left;
+				if (c < 2) {
+					length = 0;
+					for (int i = 0; i < 4; ++i) {
+						length = (length << 8) | color->at(c * 4 + i);
+					}
+				}
+				rlgr_dec.Decode(data, length, _src.symbols.data() + offset + c * slice.size, slice.size, slice.size, consumed);
+				data += length, left -= length;
+			}
+		}
+		else {
+			size_t consumed{};
+			rlgr_dec.Decode(color->data(), color->size(), _src.symbols.data() + offset, 3 * slice.size, 3 * slice.size, consumed);
+		}
+	}
+	_src.contexts.assign(_src.symbols.size(), 0);
+}
+
+int main(int argc, char** argv) {
+	int         size   = argc > 1 ? atoi(argv[1]) : (1 << 20);
+	int         repeat = argc > 2 ? atoi(argv[2]) : 10;
+	std::string slice_dir = argc > 3 ? argv[3] : "";
+
+	common::PVVCParam_t p{};
+	p.zstd_level        = 3;
+	p.octree.resolution = 1.0f;
+	auto param          = std::make_shared<const common::PVVCParam_t>(p);
+
+	std::mt19937 gen(0x5eed);
+
+	/* Laplacian with scale 32, quantized by each QP */
+	std::exponential_distribution<float> mag(1.0f / 32.0f);
+	std::bernoulli_distribution          sign(0.5);
+	std::vector<float>                   laplacian(size);
+	for (auto& i : laplacian) {
+		i = sign(gen) ? -mag(gen) : mag(gen);
+	}
+
+	/* RAHT coefficients, Y/U/V planes */
+	std::vector<common::ColorYUV> raht;
+	std::vector<uint8_t>          raht_contexts;
+	SyntheticRAHT(size / 3, param, raht, raht_contexts);
+
+	for (int qp : {1, 4, 10, 30}) {
+		Source src{"laplacian", qp, std::vector<common::FIX_DATA_INT>(size), std::vector<uint8_t>(size, 0)};
+		common::Quantize(laplacian.data(), src.symbols.data(), size, qp);
+		BenchSource(src, repeat, param);
+
+		Source coeff{"raht", qp, std::vector<common::FIX_DATA_INT>(3 * raht.size()), {}};
+		common::QuantizeYUV(raht.data(), coeff.symbols.data(), raht.size(), qp);
+		for (int c = 0; c < 3; ++c) {
+			coeff.contexts.insert(coeff.contexts.end(), raht_contexts.begin(), raht_contexts.end());
+		}
+		BenchSource(coeff, repeat, param);
+	}
+
+	if (!slice_dir.empty()) {
+		Source slices{"slices", -1, {}, {}};
+		auto   geometry = std::make_shared<std::vector<uint8_t>>();
+		LoadSlices(slice_dir, slices, geometry);
+		if (!slices.symbols.empty()) {
+			BenchSource(slices, repeat, param);
+		}
+		if (!geometry->empty()) {
+			BenchBytes("slices_geometry", geometry, repeat, param);
+		}
+	}
+
+	bool match = true;
+	printf("{\n  \"repeat\": %d,\n  \"zstd_level\": %d,\n  \"results\": [\n", repeat, p.zstd_level);
+	for (size_t i = 0; i < records.size(); ++i) {
+		auto& r = records[i];
+		printf("    {\"source\": \"%s\", \"qp\": %d, \"coder\": \"%s\", \"symbols\": %zu, \"input_bytes\": %zu, \"coded_bytes\": %zu, "
+		       "\"ratio\": %.4f, \"bits_per_symbol\": %.4f, \"encode_mb_s\": %.2f, \"decode_mb_s\": %.2f, "
+		       "\"encode_symbols_s\": %.0f, \"decode_symbols_s\": %.0f, \"match\": %s}%s\n",
+		       r.source.c_str(), r.qp, r.coder.c_str(), r.symbols, r.input_bytes, r.coded_bytes, static_cast<float>(r.input_bytes) / std::max<size_t>(r.coded_bytes, 1),
+		       r.symbols ? r.coded_bytes * 8.0f / r.symbols : 0.0f, r.input_bytes / (1024.0f * 1024.0f) / r.encode_s, r.input_bytes / (1024.0f * 1024.0f) / r.decode_s,
+		       r.symbols / r.encode_s, r.symbols / r.decode_s, r.match ? "true" : "false", i + 1 == records.size() ? "" : ",");
+		match = match && r.match;
+	}
+	printf("  ]\n}\n");
+	return match ? 0 : 1;
+}
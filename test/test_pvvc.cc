@@ -6,7 +6,7 @@ int main() {
 	auto param = p_loader.GetPVVCParam();
 
 	char t;
-	std::cout << "Select module \n\ts(segmentation)\n\td(deformation)\n\tc(compression)\n\tf(build-frame)\n\tr(decompression)\n\tother(exit)\nPlease input your selection: ";
+	std::cout << "Select module \n\ts(segmentation)\n\td(deformation)\n\tc(compression)\n\tf(build-frame)\n\tt(train-dictionary)\n\tr(decompression)\n\tother(exit)\nPlease input your selection: ";
 	t = getchar();
 	if (t == 's' || t == 'S') {
 		vvc::codec::PVVCSegmentation seg;
@@ -32,6 +32,9 @@ int main() {
 	else if (t == 'f' || t == 'F') {
 		vvc::codec::BuildFrames(param);
 	}
+	else if (t == 't' || t == 'T') {
+		vvc::codec::TrainDictionaries(param);
+	}
 	else if (t == 'r' || t == 'R') {
 		vvc::codec::PVVCDecompression dec;
 		dec.SetParams(param);